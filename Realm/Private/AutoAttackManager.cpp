@@ -12,9 +12,10 @@ UAutoAttackManager::UAutoAttackManager(const FObjectInitializer& objectInitializ
 void UAutoAttackManager::InitializeManager(TArray<FAutoAttack>& attacks, UStatsManager* stats)
 {
 	autoAttacks = attacks;
+	statsManager = stats;
 	
-	if (IsValid(stats) && autoAttacks.Num() > 0)
-		stats->baseStats[(uint8)EStat::ES_AARange] = autoAttacks[0].attackRange;
+	if (IsValid(statsManager) && autoAttacks.Num() > 0)
+		statsManager->SetBaseStat(EStat::ES_AARange, autoAttacks[currentAttackIndex].attackRange);
 }
 
 float UAutoAttackManager::GetCurrentAutoAttackRange() const
@@ -76,7 +77,13 @@ float UAutoAttackManager::GetAutoAttackLaunchTime() const
 void UAutoAttackManager::SetAutoAttackIndex(int32 newIndex)
 {
 	if (newIndex >= 0 && newIndex < autoAttacks.Num())
+	{
 		currentAttackIndex = newIndex;
+
+		//only the server knows the stats manager, the range replicates from there
+		if (IsValid(statsManager))
+			statsManager->SetBaseStat(EStat::ES_AARange, autoAttacks[currentAttackIndex].attackRange);
+	}
 }
 
 USoundCue* UAutoAttackManager::GetCurrentAutoAttackLaunchSound() const
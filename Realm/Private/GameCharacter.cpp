@@ -26,7 +26,15 @@ AGameCharacter::AGameCharacter(const FObjectInitializer& objectInitializer)
 		aaDamagedParticleSystem = aaPs.Object;
 
 	AIControllerClass = AAIController::StaticClass();
-	bAlwaysRelevant = true;
+
+	//only players whose team can see this character get its updates
+	bAlwaysRelevant = false;
+	bUseVisionRelevancy = true;
+	visionRelevancyGracePeriod = 1.f;
+	visibleTeamsMask = 0;
+	FMemory::Memzero(teamSightLostTimes, sizeof(teamSightLostTimes));
+	teamVision = nullptr;
+	teamVisionIndex = INDEX_NONE;
 
 	level = 1;
 	experienceAmount = 0;
@@ -43,6 +51,9 @@ AGameCharacter::AGameCharacter(const FObjectInitializer& objectInitializer)
 
 	lastTakeHitTimeTimeout = 2.f;
 	damagedSightTimeout = 2.f;
+
+	pendingHitStart = 0;
+	pendingHitCount = 0;
 }
 
 void AGameCharacter::BeginPlay()
@@ -76,7 +87,26 @@ void AGameCharacter::BeginPlay()
 		statsManager->SetMaxHealth();
 		statsManager->SetMaxFlare();
 
+		//only push the movement speed to the movement component when it changes
+		statsManager->OnStatChanged(EStat::ES_Move).AddUObject(this, &AGameCharacter::OnMovementSpeedChanged);
+		GetCharacterMovement()->MaxWalkSpeed = GetCurrentValueForStat(EStat::ES_Move);
+
+		//a change in max health or flare can leave us above or below it
+		statsManager->OnStatChanged(EStat::ES_HP).AddUObject(this, &AGameCharacter::OnMaxResourceChanged);
+		statsManager->OnStatChanged(EStat::ES_Flare).AddUObject(this, &AGameCharacter::OnMaxResourceChanged);
+
 		modManager->managedCharacter = this;
+
+		ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+		if (IsValid(gm))
+			gm->GetCharacterHash().AddCharacter(this);
+	}
+	else
+	{
+		//characters that show up after our fog of war was applied start hidden unless our team can see them
+		ARealmPlayerController* localPC = Cast<ARealmPlayerController>(GetWorld()->GetFirstPlayerController());
+		if (IsValid(localPC) && IsValid(localPC->fogOfWar))
+			localPC->fogOfWar->InitializeCharacterSight(this);
 	}
 
 	for (TActorIterator<AHUD> objItr(GetWorld()); objItr; ++objItr)
@@ -97,6 +127,21 @@ void AGameCharacter::BeginPlay()
 	}
 }
 
+void AGameCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//stop giving our team sight and showing up in range queries once we leave the game
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+	{
+		gm->GetVisionGrid().RemoveFootprint(visionFootprint);
+		gm->GetCharacterHash().RemoveCharacter(this);
+		gm->GetDamageOverTime().RemoveTarget(this);
+		gm->GetRegeneration().RemoveCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AGameCharacter::Destroy(bool bNetForce /* = false */, bool bShouldModifyLevel /* = true */)
 {
 	//autoAttackManager->Destroy();
@@ -123,39 +168,6 @@ void AGameCharacter::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
-	if (Role == ROLE_Authority)
-	{
-		GetCharacterMovement()->MaxWalkSpeed = GetCurrentValueForStat(EStat::ES_Move);
-
-		if (IsValid(GetStatsManager()) && IsValid(GetAutoAttackManager()))
-			GetStatsManager()->baseStats[(uint8)EStat::ES_AARange] = GetAutoAttackManager()->GetCurrentAutoAttackRange();
-
-		if (IsAlive())
-		{
-			if (GetHealth() < GetCurrentValueForStat(EStat::ES_HP))
-			{
-				if (GetWorldTimerManager().GetTimerRemaining(healthRegen) <= 0.f)
-					GetWorldTimerManager().SetTimer(healthRegen, this, &AGameCharacter::HealthRegen, 0.25f, true);
-			}
-			else if (GetHealth() > GetCurrentValueForStat(EStat::ES_HP))
-			{
-				GetWorldTimerManager().ClearTimer(healthRegen);
-				statsManager->health = GetCurrentValueForStat(EStat::ES_HP);
-			}
-
-			if (GetFlare() < GetCurrentValueForStat(EStat::ES_Flare))
-			{
-				if (GetWorldTimerManager().GetTimerRemaining(flareRegen) <= 0.f)
-					GetWorldTimerManager().SetTimer(flareRegen, this, &AGameCharacter::FlareRegen, 0.25f, true);
-			}
-			else if (GetFlare() > GetCurrentValueForStat(EStat::ES_Flare))
-			{
-				GetWorldTimerManager().ClearTimer(flareRegen);
-				statsManager->flare = GetCurrentValueForStat(EStat::ES_Flare);
-			}
-		}
-	}
-
 	if (IsValid(GetCurrentTarget()) && GetCurrentTarget()->IsAlive() && IsAlive())
 	{
 		FRotator newRot = GetActorRotation();
@@ -166,72 +178,121 @@ void AGameCharacter::Tick(float DeltaSeconds)
 		//SetActorRotation(newRot);
 	}
 
+	if (IsValid(statsManager))
+		statsManager->FlushEffectsUpdated();
+
 	if (!IsValid(GetWorld()->GetFirstPlayerController()))
 		return;
 }
 
-void AGameCharacter::ReplicateHit(float damage, struct FDamageEvent const& damageEvent, class APawn* instigatingPawn, class AActor* damageCauser, bool bKilled, FRealmDamage& realmDamage, FDamageRecap& damageDesc)
+void AGameCharacter::OnMovementSpeedChanged(EStat stat, float newValue)
 {
-	const float timeoutTime = GetWorld()->GetTimeSeconds() + 0.5f;
+	GetCharacterMovement()->MaxWalkSpeed = newValue;
+}
 
-	/*FDamageEvent lastDamageEvent = lastTakeHitInfo.GetDamageEvent();
-	if ((instigatingPawn == lastTakeHitInfo.PawnInstigator) && (lastDamageEvent.DamageTypeClass == lastTakeHitInfo.DamageTypeClass) && (lastTakeHitTimeTimeout == timeoutTime))
-	{
-		// same frame damage
-		if (bKilled && lastTakeHitInfo.bKilled)
-		{
-			// Redundant death take hit, just ignore it
-			return;
-		}
+void AGameCharacter::OnMaxResourceChanged(EStat stat, float newValue)
+{
+	StartRegeneration();
+}
 
-		// otherwise, accumulate damage done this frame
-		damage += lastTakeHitInfo.ActualDamage;
-	}*/
+void AGameCharacter::ReplicateHit(float damage, struct FDamageEvent const& damageEvent, class APawn* instigatingPawn, class AActor* damageCauser, bool bKilled, FRealmDamage& realmDamage, FDamageRecap& damageDesc)
+{
+	const float worldTime = GetWorld()->GetTimeSeconds();
+	AGameCharacter* instigatingCharacter = Cast<AGameCharacter>(instigatingPawn);
 
 	lastTakeHitInfo.ActualDamage = damage;
 	lastTakeHitInfo.realmDamage = realmDamage;
-	lastTakeHitInfo.PawnInstigator = Cast<AGameCharacter>(instigatingPawn);
+	lastTakeHitInfo.PawnInstigator = instigatingCharacter;
 	lastTakeHitInfo.DamageCauser = damageCauser;
 	lastTakeHitInfo.SetDamageEvent(damageEvent);
 	lastTakeHitInfo.bKilled = bKilled;
 	lastTakeHitInfo.damageName = damageDesc.damageName;
 	lastTakeHitInfo.characterClass = damageDesc.characterClass;
-	lastTakeHitInfo.EnsureReplication();
 
-	lastTakeHitTimeTimeout = timeoutTime;
+	//sum hits from the same instigator and damage type that land before the next net update
+	bool bMerged = false;
+	for (int32 i = 0; i < pendingHitCount; i++)
+	{
+		FTakeHitInfo& pendingHit = pendingHits[(pendingHitStart + i) % MAX_PENDING_HITS];
+		if (pendingHit.PawnInstigator == lastTakeHitInfo.PawnInstigator && pendingHit.DamageTypeClass == lastTakeHitInfo.DamageTypeClass)
+		{
+			pendingHit.ActualDamage += damage;
+			pendingHit.bKilled = pendingHit.bKilled || bKilled;
+			bMerged = true;
+			break;
+		}
+	}
+
+	if (!bMerged)
+	{
+		//drop the oldest hit if the buffer is full
+		if (pendingHitCount == MAX_PENDING_HITS)
+		{
+			pendingHitStart = (pendingHitStart + 1) % MAX_PENDING_HITS;
+			pendingHitCount--;
+		}
 
-	lastDamagingCharacter = Cast<AGameCharacter>(instigatingPawn);
-	GetWorldTimerManager().SetTimer(clearLastHitTimer, this, &AGameCharacter::ClearLastTakeHit, 2.f, false);
+		pendingHits[(pendingHitStart + pendingHitCount) % MAX_PENDING_HITS] = lastTakeHitInfo;
+		pendingHitCount++;
+	}
 
-	FTimerHandle h;
-	GetWorldTimerManager().SetTimer(h, FTimerDelegate::CreateUObject(this, &AGameCharacter::RemoveDamagedSightCharacter, instigatingPawn->GetFName()), damagedSightTimeout, false);
-	damagedSightCharacters.Add(instigatingPawn->GetFName(), Cast<AGameCharacter>(instigatingPawn));
-}
+	lastTakeHitTimeTimeout = worldTime + 0.5f;
 
-void AGameCharacter::RemoveDamagedSightCharacter(FName charName)
-{
-	if (damagedSightCharacters.Contains(charName))
-		damagedSightCharacters.Remove(charName);
+	if (IsValid(instigatingCharacter))
+		AddCombatReveal(instigatingCharacter, worldTime);
 }
 
-void AGameCharacter::ClearLastTakeHit()
+void AGameCharacter::AddCombatReveal(AGameCharacter* attacker, float worldTime)
 {
-	lastDamagingCharacter = nullptr;
+	const float expireTime = worldTime + damagedSightTimeout;
+	for (FCombatReveal& reveal : damagedSightCharacters)
+	{
+		if (reveal.attacker == attacker)
+		{
+			reveal.expireTime = expireTime;
+			return;
+		}
+	}
+
+	FCombatReveal reveal;
+	reveal.attacker = attacker;
+	reveal.expireTime = expireTime;
+	damagedSightCharacters.Add(reveal);
 }
 
-void AGameCharacter::OnRep_LastTakeHitInfo()
+void AGameCharacter::GatherCombatReveals(float worldTime, TSet<AGameCharacter*>& outRevealed)
 {
-	FDamageRecap dr;
-	dr.characterClass = lastTakeHitInfo.characterClass;
-	dr.damageName = lastTakeHitInfo.damageName;
-
-	if (lastTakeHitInfo.bKilled)
+	for (int32 i = damagedSightCharacters.Num() - 1; i >= 0; i--)
 	{
-		OnDeath(lastTakeHitInfo.ActualDamage, lastTakeHitInfo.GetDamageEvent(), lastTakeHitInfo.PawnInstigator, lastTakeHitInfo.DamageCauser.Get(), lastTakeHitInfo.realmDamage, dr);
+		const FCombatReveal& reveal = damagedSightCharacters[i];
+		if (worldTime >= reveal.expireTime || !reveal.attacker.IsValid())
+			damagedSightCharacters.RemoveAtSwap(i);
+		else
+			outRevealed.Add(reveal.attacker.Get());
 	}
-	else if (Role < ROLE_Authority)
+}
+
+void AGameCharacter::OnRep_HitBundle()
+{
+	//play every hit before a death so the death is the last thing we see
+	for (int32 pass = 0; pass < 2; pass++)
 	{
-		PlayHit(lastTakeHitInfo.ActualDamage, lastTakeHitInfo.GetDamageEvent(), lastTakeHitInfo.PawnInstigator, lastTakeHitInfo.DamageCauser.Get(), lastTakeHitInfo.realmDamage, dr);
+		for (const FTakeHitInfo& hit : hitBundle.hits)
+		{
+			if (hit.bKilled != (pass == 1))
+				continue;
+
+			lastTakeHitInfo = hit;
+
+			FDamageRecap dr;
+			dr.characterClass = lastTakeHitInfo.characterClass;
+			dr.damageName = lastTakeHitInfo.damageName;
+
+			if (lastTakeHitInfo.bKilled)
+				OnDeath(lastTakeHitInfo.ActualDamage, lastTakeHitInfo.GetDamageEvent(), lastTakeHitInfo.PawnInstigator, lastTakeHitInfo.DamageCauser.Get(), lastTakeHitInfo.realmDamage, dr);
+			else if (Role < ROLE_Authority)
+				PlayHit(lastTakeHitInfo.ActualDamage, lastTakeHitInfo.GetDamageEvent(), lastTakeHitInfo.PawnInstigator, lastTakeHitInfo.DamageCauser.Get(), lastTakeHitInfo.realmDamage, dr);
+		}
 	}
 }
 
@@ -443,13 +504,21 @@ void AGameCharacter::LaunchAutoAttack()
 		//launch a projectile
 		FVector spawnPos = GetMesh()->GetSocketLocation(autoAttackManager->GetCurrentAutoAttackProjectileSocket());
 		FRotator dir = (GetCurrentTarget()->GetActorLocation() - GetActorLocation()).Rotation();
-		AProjectile* attackProjectile = GetWorld()->SpawnActor<AProjectile>(autoAttackManager->GetCurrentAutoAttackProjectileClass(), spawnPos, dir);
+		TSubclassOf<AProjectile> projectileClass = autoAttackManager->GetCurrentAutoAttackProjectileClass();
+		ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
 
-		if (IsValid(attackProjectile))
+		//homing shots don't need an actor on the server, clients are told to draw them
+		if (IsValid(gm) && *projectileClass && projectileClass->GetDefaultObject<AProjectile>()->bServerSimulatedShot)
+			gm->GetAutoAttackShots().FireShot(this, GetCurrentTarget(), projectileClass, spawnPos, scale, dmg, rdmg, autoAttackManager->GetCurrentAutoAttackHitSound());
+		else
 		{
-			attackProjectile->bAutoAttackProjectile = true;
-			attackProjectile->hitSound = autoAttackManager->GetCurrentAutoAttackHitSound();
-			attackProjectile->InitializeProjectile(dir.Vector(), dmg, UPhysicalDamage::StaticClass(), this, GetCurrentTarget(), rdmg, scale);
+			AProjectile* attackProjectile = AProjectile::SpawnPooledProjectile(this, projectileClass, spawnPos, dir);
+			if (IsValid(attackProjectile))
+			{
+				attackProjectile->bAutoAttackProjectile = true;
+				attackProjectile->hitSound = autoAttackManager->GetCurrentAutoAttackHitSound();
+				attackProjectile->InitializeProjectile(dir.Vector(), dmg, UPhysicalDamage::StaticClass(), this, GetCurrentTarget(), rdmg, scale);
+			}
 		}
 	}
 	else
@@ -614,6 +683,16 @@ bool AGameCharacter::AllStopAnimMontage_Validate(class UAnimMontage* AnimMontage
 	return true;
 }
 
+void AGameCharacter::AllShotFired_Implementation(AGameCharacter* target, TSubclassOf<AProjectile> projectileClass, FVector_NetQuantize launchLocation, float speed)
+{
+	if (GetNetMode() == NM_DedicatedServer || !IsValid(target) || !*projectileClass)
+		return;
+
+	AProjectile* shot = GetWorld()->SpawnActor<AProjectile>(projectileClass, launchLocation, (target->GetActorLocation() - launchLocation).Rotation());
+	if (IsValid(shot))
+		shot->InitializeCosmeticShot(this, target, speed);
+}
+
 void AGameCharacter::AllPlayAnimMontage_Implementation(class UAnimMontage* AnimMontage, float InPlayRate)
 {
 	USkeletalMeshComponent* UseMesh = GetMesh();
@@ -685,12 +764,12 @@ float AGameCharacter::GetUnaffectedValueForStat(EStat stat) const
 		return -1.f;
 }
 
-AEffect* AGameCharacter::AddEffect(const FText& effectName, const FText& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration, FString const& keyName, bool bStacking, bool bMultipleInfliction, bool bPersistThroughDeath)
+bool AGameCharacter::AddEffect(const FText& effectName, const FText& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration, FString const& keyName, bool bStacking, bool bMultipleInfliction, bool bPersistThroughDeath)
 {
 	if (Role == ROLE_Authority && statsManager)
 		return statsManager->AddEffect(effectName, effectDescription, stats, amounts, effectDuration, keyName, bStacking, bMultipleInfliction, bPersistThroughDeath);
 	else
-		return nullptr;
+		return false;
 }
 
 void AGameCharacter::AddEffectStacks(const FString& effectKey, int32 stackAmount)
@@ -706,7 +785,7 @@ void AGameCharacter::EndEffect(const FString& effectKey)
 }
 
 
-void AGameCharacter::CharacterTakeDamageOverTime(float Damage, float damageTime, int32 tickCount, FString& dotKey, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, class AActor* DamageCauser, UPARAM(ref) FRealmDamage& realmDamage, UPARAM(ref) FDamageRecap& damageDesc)
+void AGameCharacter::CharacterTakeDamageOverTime(float Damage, float damageTime, int32 tickCount, FString& dotKey, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, class AActor* DamageCauser, UPARAM(ref) FRealmDamage& realmDamage, UPARAM(ref) FDamageRecap& damageDesc, EDoTStackPolicy stackPolicy)
 {
 	if (Role < ROLE_Authority)
 		return;
@@ -714,21 +793,18 @@ void AGameCharacter::CharacterTakeDamageOverTime(float Damage, float damageTime,
 	if (!IsValid(statsManager) || !IsAlive())
 		return;
 
-	if (dotEvents.Contains(dotKey))
-	{
-		//reset dots if they already exist
-		dotEvents[dotKey].incurredTickDamage = 0.f;
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
 		return;
-	}
 
-	if (damageTime > 0.f && Damage > 0.f)
+	if (damageTime > 0.f && Damage > 0.f && tickCount > 0)
 	{
 		ARealmPlayerController* pc = Cast<ARealmPlayerController>(EventInstigator);
 		ARealmMoveController* aipc = Cast<ARealmMoveController>(EventInstigator);
 		AGameCharacter* damageCausingGC = NULL;
 
 		//subtract the right type of defense for the tot DoT
-		if (!GetWorld()->GetAuthGameMode<ARealmGameMode>()->CanDamageFriendlies() && ((pc && pc->GetPlayerCharacter()->GetTeamIndex() == teamIndex) || (damageCausingGC && damageCausingGC->GetTeamIndex() == teamIndex)))
+		if (!gm->CanDamageFriendlies() && ((pc && pc->GetPlayerCharacter()->GetTeamIndex() == teamIndex) || (damageCausingGC && damageCausingGC->GetTeamIndex() == teamIndex)))
 			return;
 
 		if (DamageEvent.DamageTypeClass == UPhysicalDamage::StaticClass() && statsManager->GetCurrentValueForStat(EStat::ES_Def) >= 0)
@@ -737,12 +813,8 @@ void AGameCharacter::CharacterTakeDamageOverTime(float Damage, float damageTime,
 			Damage -= statsManager->GetCurrentValueForStat(EStat::ES_SpDef);
 		
 		FDamageOverTime dot;
-		FTimerHandle dotTimer;
-
-		GetWorldTimerManager().SetTimer(dotTimer, FTimerDelegate::CreateUObject(this, &AGameCharacter::DamageOverTimeTick, dotKey), damageTime / (float)tickCount, true);
 		dot.DamageCauser = DamageCauser;
 		dot.DamageEvent = DamageEvent;
-		dot.dotTimer = dotTimer;
 		dot.EventInstigator = EventInstigator;
 		dot.realmDamage = realmDamage;
 		dot.tickDamage = Damage / (float)tickCount;
@@ -750,16 +822,18 @@ void AGameCharacter::CharacterTakeDamageOverTime(float Damage, float damageTime,
 		dot.tickInterval = damageTime / (float)tickCount;
 		dot.dotDuration = damageTime;
 		dot.damageDesc = damageDesc;
+		dot.tickCount = tickCount;
+		dot.dotKey = dotKey;
+		dot.target = this;
 
-		dotEvents.Add(dotKey, dot);
-		DamageOverTimeTick(dotKey);
+		gm->GetDamageOverTime().ApplyDoT(dot, stackPolicy);
 	}
 }
 
-void AGameCharacter::DamageOverTimeTick(FString dotKey)
+void AGameCharacter::DamageOverTimeTick(const FDamageOverTime& dot)
 {
-	ARealmPlayerController* pc = Cast<ARealmPlayerController>(dotEvents[dotKey].EventInstigator);
-	ARealmMoveController* aipc = Cast<ARealmMoveController>(dotEvents[dotKey].EventInstigator);
+	ARealmPlayerController* pc = Cast<ARealmPlayerController>(dot.EventInstigator);
+	ARealmMoveController* aipc = Cast<ARealmMoveController>(dot.EventInstigator);
 	AGameCharacter* damageCausingGC = NULL;
 
 	if (aipc)
@@ -773,18 +847,18 @@ void AGameCharacter::DamageOverTimeTick(FString dotKey)
 		pc->GetMoveController()->CharacterDamaged(this);
 	}
 
-	if (IsValid(dotEvents[dotKey].realmDamage.controllingCharacter))
-		damageCausingGC = dotEvents[dotKey].realmDamage.controllingCharacter;
+	if (IsValid(dot.realmDamage.controllingCharacter))
+		damageCausingGC = dot.realmDamage.controllingCharacter;
 
 	if (bOnlySpecificCharactersCanDamage && !specificDamagingCharacters.Contains(damageCausingGC))
 		return;
 
-	CharacterDamaged(dotEvents[dotKey].tickDamage, dotEvents[dotKey].DamageEvent.DamageTypeClass, damageCausingGC, dotEvents[dotKey].DamageCauser);
+	CharacterDamaged(dot.tickDamage, dot.DamageEvent.DamageTypeClass, damageCausingGC, dot.DamageCauser);
 
 	if (IsValid(damageCausingGC))
 	{
-		damageCausingGC->HurtAnother(this, dotEvents[dotKey].DamageEvent, dotEvents[dotKey].tickDamage, dotEvents[dotKey].realmDamage);
-		damageCausingGC->modManager->CharacterDealtDamage(dotEvents[dotKey].tickDamage, dotEvents[dotKey].DamageEvent.DamageTypeClass, dotEvents[dotKey].DamageCauser, dotEvents[dotKey].realmDamage, this);
+		damageCausingGC->HurtAnother(this, dot.DamageEvent, dot.tickDamage, dot.realmDamage);
+		damageCausingGC->modManager->CharacterDealtDamage(dot.tickDamage, dot.DamageEvent.DamageTypeClass, dot.DamageCauser, dot.realmDamage, this);
 	}
 
 	CharacterCombatAction();
@@ -800,19 +874,12 @@ void AGameCharacter::DamageOverTimeTick(FString dotKey)
 		}
 	}
 
-	if (GetHealth() - dotEvents[dotKey].tickDamage > 0)
-		PlayHit(dotEvents[dotKey].tickDamage, dotEvents[dotKey].DamageEvent, damageCausingGC, dotEvents[dotKey].DamageCauser, dotEvents[dotKey].realmDamage, dotEvents[dotKey].damageDesc);
+	if (GetHealth() - dot.tickDamage > 0)
+		PlayHit(dot.tickDamage, dot.DamageEvent, damageCausingGC, dot.DamageCauser, dot.realmDamage, dot.damageDesc);
 	else
-		Die(dotEvents[dotKey].tickDamage, dotEvents[dotKey].DamageEvent, damageCausingGC, dotEvents[dotKey].DamageCauser, dotEvents[dotKey].realmDamage, dotEvents[dotKey].damageDesc);
+		Die(dot.tickDamage, dot.DamageEvent, damageCausingGC, dot.DamageCauser, dot.realmDamage, dot.damageDesc);
 
-	TakeDamage(dotEvents[dotKey].tickDamage, dotEvents[dotKey].DamageEvent, dotEvents[dotKey].EventInstigator, dotEvents[dotKey].DamageCauser);
-
-	dotEvents[dotKey].incurredTickDamage += dotEvents[dotKey].tickInterval;
-	if (dotEvents[dotKey].incurredTickDamage >= dotEvents[dotKey].dotDuration)
-	{
-		GetWorldTimerManager().ClearTimer(dotEvents[dotKey].dotTimer);
-		dotEvents.Remove(dotKey);
-	}
+	TakeDamage(dot.tickDamage, dot.DamageEvent, dot.EventInstigator, dot.DamageCauser);
 }
 
 float AGameCharacter::CharacterTakeDamage(float Damage, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, class AActor* DamageCauser, FRealmDamage& realmDamage, FDamageRecap& damageDesc)
@@ -929,9 +996,6 @@ float AGameCharacter::TakeDamage(float Damage, struct FDamageEvent const& Damage
 			modManager->CharacterDamaged(ActualDamage, DamageEvent.DamageTypeClass, damageCausingGC, DamageCauser, lastTakeHitInfo.realmDamage);
 
 		MakeNoise(1.0f, EventInstigator ? EventInstigator->GetPawn() : this);
-
-		if (!GetWorldTimerManager().IsTimerActive(healthRegen) && IsAlive())
-			GetWorldTimerManager().SetTimer(healthRegen, this, &AGameCharacter::HealthRegen, 0.25f, true);
 	}
 
 	return ActualDamage;
@@ -957,33 +1021,36 @@ void AGameCharacter::UseFlare(float amount)
 {
 	if (IsValid(statsManager))
 		statsManager->RemoveFlare(amount);
-
-	if (!GetWorldTimerManager().IsTimerActive(healthRegen))
-		GetWorldTimerManager().SetTimer(flareRegen, this, &AGameCharacter::FlareRegen, 0.25f, true);
 }
 
-void AGameCharacter::HealthRegen()
+void AGameCharacter::StartRegeneration()
 {
-	float hr = statsManager->GetCurrentValueForStat(EStat::ES_HPRegen) / 4.f;
-	if (GetHealth() + hr < statsManager->GetCurrentValueForStat(EStat::ES_HP))
-		statsManager->RemoveHealth(hr * -1);
-	else
-	{
-		statsManager->SetMaxHealth();
-		GetWorldTimerManager().ClearTimer(healthRegen);
-	}
+	if (Role < ROLE_Authority || !IsAlive())
+		return;
+
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+		gm->GetRegeneration().AddCharacter(this);
 }
 
-void AGameCharacter::FlareRegen()
+bool AGameCharacter::Regenerate(float interval)
 {
-	float hr = statsManager->GetCurrentValueForStat(EStat::ES_FlareRegen) / 4.f;
-	if (GetFlare() + hr < statsManager->GetCurrentValueForStat(EStat::ES_Flare))
-		statsManager->RemoveFlare(hr * -1);
-	else
-	{
-		statsManager->SetMaxFlare();
-		GetWorldTimerManager().ClearTimer(flareRegen);
-	}
+	if (!IsValid(statsManager))
+		return false;
+
+	const float maxHealth = GetCurrentValueForStat(EStat::ES_HP);
+	if (GetHealth() < maxHealth)
+		statsManager->RemoveHealth(-FMath::Min(GetCurrentValueForStat(EStat::ES_HPRegen) * interval, maxHealth - GetHealth()));
+	else if (GetHealth() > maxHealth)
+		statsManager->health = maxHealth;
+
+	const float maxFlare = GetCurrentValueForStat(EStat::ES_Flare);
+	if (GetFlare() < maxFlare)
+		statsManager->RemoveFlare(-FMath::Min(GetCurrentValueForStat(EStat::ES_FlareRegen) * interval, maxFlare - GetFlare()));
+	else if (GetFlare() > maxFlare)
+		statsManager->flare = maxFlare;
+
+	return GetHealth() < maxHealth || GetFlare() < maxFlare;
 }
 
 bool AGameCharacter::IsAlive() const
@@ -1042,23 +1109,21 @@ bool AGameCharacter::Die(float KillingDamage, FDamageEvent const& DamageEvent, A
 
 	if (Role == ROLE_Authority)
 	{
-		TArray<AEffect*> charEffects;
+		TArray<FRealmEffect> charEffects;
 		statsManager->GetEffects(charEffects);
-		for (AEffect* effect : charEffects)
+		for (const FRealmEffect& effect : charEffects)
 		{
-			if (effect->bIsTransferredToPlayerKiller)
+			if (effect.bIsTransferredToPlayerKiller)
 			{
 				APlayerCharacter* gc = Cast<APlayerCharacter>(Killer);
 				if (IsValid(gc))
 				{
-					if (!IsValid(gc->AddEffect(effect->uiName, effect->description, effect->stats, effect->amounts, effect->duration, effect->keyName, effect->bStacking, effect->bCanBeInflictedMultipleTimes)))
+					if (!gc->AddEffect(effect.uiName, effect.description, effect.stats, effect.amounts, effect.duration, effect.keyName, effect.bStacking, effect.bCanBeInflictedMultipleTimes))
 					{
 						if (!IsValid(gc->statsManager))
 							break;
 
-						AEffect* exisitingEffect = gc->statsManager->GetEffect(effect->keyName);
-						if (IsValid(exisitingEffect))
-							exisitingEffect->ResetEffectTimer();
+						gc->statsManager->ResetEffectTimer(effect.keyName);
 					}
 				}
 			}
@@ -1121,34 +1186,28 @@ void AGameCharacter::OnDeath(float KillingDamage, struct FDamageEvent const& Dam
 	{
 		ReplicateHit(KillingDamage, DamageEvent, PawnInstigator, DamageCauser, true, realmDamage, damageDesc);
 
-		TArray<APlayerCharacter*> gcs;
-		for (TActorIterator<APlayerCharacter> gcitr(GetWorld()); gcitr; ++gcitr)
+		//every living enemy mythos nearby except the killer shares the assist experience
+		TArray<AGameCharacter*> gcs;
+		ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+		if (IsValid(gm))
 		{
-			APlayerCharacter* gc = (*gcitr);
-			if (!IsValid(gc))
-				continue;
+			FRealmCharacterFilter filter;
+			filter.excludedTeam = GetTeamIndex();
+			filter.characterClass = APlayerCharacter::StaticClass();
+			filter.ignoredCharacter = gc;
 
-			float distsq = (gc->GetActorLocation() - GetActorLocation()).SizeSquared2D();
-			if (distsq <= FMath::Square(experienceRewardRange) && GetTeamIndex() != gc->GetTeamIndex() && gc != PawnInstigator && gc->IsAlive())
-				gcs.AddUnique(gc);
+			gm->GetCharacterHash().QueryRadius(GetActorLocation(), experienceRewardRange, filter, gcs);
 		}
 
 		if (IsValid(gc))
 			gc->GiveCharacterExperience((baseExpReward + (level * 2.45f)));
 
-		for (APlayerCharacter* gcc : gcs)
-		{
-			if (gcc != gc)
-				gcc->GiveCharacterExperience(baseExpReward / gcs.Num());
-		}
+		for (AGameCharacter* gcc : gcs)
+			gcc->GiveCharacterExperience(baseExpReward / gcs.Num());
 
 		OnCharacterDied(KillingDamage, PawnInstigator, DamageCauser, realmDamage);
 	}
 
-	GetWorldTimerManager().ClearTimer(flareRegen);
-	GetWorldTimerManager().ClearTimer(healthRegen);
-	GetWorldTimerManager().ClearTimer(clearLastHitTimer);
-
 	if ((IsValid(gc) && gc->playerController == GetWorld()->GetFirstPlayerController()) || playerController == GetWorld()->GetFirstPlayerController())
 	{
 		if (IsValid(gc->playerController))
@@ -1519,38 +1578,12 @@ FAilmentInfo AGameCharacter::MakeAilmentInfo(EAilment ailment, FString ailmentSt
 	return info;
 }
 
-void AGameCharacter::CalculateVisibility(TArray<AGameCharacter*>& sightList)
+void AGameCharacter::CalculateVisibility(FRealmVisibilityGrid& visionGrid)
 {
-	ARealmPlayerController* localPC = Cast<ARealmPlayerController>(GetWorld()->GetFirstPlayerController());
-	if (!IsValid(localPC))
-		return;
-
-	ARealmPlayerState* localPS = Cast<ARealmPlayerState>(localPC->PlayerState);
-	if (!IsValid(localPS))
-		return;
-
-	TArray<FHitResult> hits;
-	FVector start = GetActorLocation();
-	FVector end = start;
-	end.Z += 5.f;
-
-	GetWorld()->SweepMultiByChannel(hits, start, end, GetActorRotation().Quaternion(), ECC_Visibility, FCollisionShape::MakeSphere(sightRadius));
-	for (int32 i = 0; i < hits.Num(); i++)
-	{
-		AGameCharacter* gc = Cast<AGameCharacter>(hits[i].GetActor());
-		if (IsValid(gc))
-		{
-			end = gc->GetActorLocation();
-			TArray<FHitResult> tHits;
-			GetWorld()->LineTraceMultiByChannel(tHits, start, end, ECC_Visibility);
-
-			for (FHitResult hit : tHits)
-			{
-				if (hit.GetActor() == gc)
-					sightList.AddUnique(gc);
-			}
-		}
-	}
+	if (IsAlive())
+		visionGrid.UpdateFootprint(visionFootprint, teamIndex, GetActorLocation(), sightRadius);
+	else
+		visionGrid.RemoveFootprint(visionFootprint);
 }
 
 bool AGameCharacter::CanEnemyAbsolutelySeeThisUnit() const
@@ -1697,6 +1730,19 @@ FVector AGameCharacter::FindGroundBeneathCharacter(AGameCharacter* testCharacter
 		return testCharacter->GetActorLocation();
 }
 
+bool AGameCharacter::HasLineOfSightTo(const AGameCharacter* otherCharacter) const
+{
+	if (!IsValid(otherCharacter))
+		return false;
+
+	//only the server has the vision grid
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
+		return true;
+
+	return gm->GetVisionGrid().HasLineOfSight(GetActorLocation(), otherCharacter->GetActorLocation());
+}
+
 bool AGameCharacter::CanSeeOtherCharacter(AGameCharacter* testCharacter, bool bTestForThisCharacter)
 {
 	if (!IsValid(testCharacter))
@@ -1706,22 +1752,41 @@ bool AGameCharacter::CanSeeOtherCharacter(AGameCharacter* testCharacter, bool bT
 	if (testCharacter->CanEnemyAbsolutelySeeThisUnit() || testCharacter->GetTeamIndex() == teamIndex)
 		return true;
 
-	FVector start = GetActorLocation();
-	FVector end = testCharacter->GetActorLocation();
-
-	float dist = (start - end).Size2D();
-	if (dist > sightRadius)
+	if ((GetActorLocation() - testCharacter->GetActorLocation()).SizeSquared2D() > FMath::Square(sightRadius))
 		return false;
 
-	//check the first fow manager we find for this team and see if we can see the tested character
-	for (TObjectIterator<URealmFogofWarManager> Itr; Itr; ++Itr)
+	//the server keeps which teams can see each character as a bitmask
+	if (HasAuthority())
+		return teamIndex >= 0 && teamIndex < VISION_MAX_TEAMS && (testCharacter->visibleTeamsMask & (1 << teamIndex)) != 0;
+
+	URealmFogofWarManager* fow = GetTeamVision();
+	return IsValid(fow) && fow->IsCharacterVisible(testCharacter);
+}
+
+URealmFogofWarManager* AGameCharacter::GetTeamVision()
+{
+	if (teamVisionIndex == teamIndex && IsValid(teamVision))
+		return teamVision;
+
+	teamVision = nullptr;
+	teamVisionIndex = teamIndex;
+
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+	{
+		if (gm->teamFoWs.IsValidIndex(teamIndex))
+			teamVision = gm->teamFoWs[teamIndex];
+	}
+	else
 	{
-		URealmFogofWarManager* fow = (*Itr);
-		if (IsValid(fow) && fow->teamIndex == GetTeamIndex())
-			return fow->enemySightList.Contains(testCharacter);
+		//clients only know the vision of the local player's team
+		ARealmPlayerController* localPC = Cast<ARealmPlayerController>(GetWorld()->GetFirstPlayerController());
+		ARealmPlayerState* localPS = IsValid(localPC) ? Cast<ARealmPlayerState>(localPC->PlayerState) : nullptr;
+		if (IsValid(localPS) && localPS->GetTeamIndex() == teamIndex)
+			teamVision = localPC->fogOfWar;
 	}
 
-	return false;
+	return teamVision;
 }
 
 void AGameCharacter::SetGloabalAnimRate(float newAnimRate)
@@ -1732,27 +1797,64 @@ void AGameCharacter::SetGloabalAnimRate(float newAnimRate)
 
 bool AGameCharacter::HasSpecifiedDoT(FString dotKey)
 {
-	return dotEvents.Contains(dotKey);
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	return IsValid(gm) && gm->GetDamageOverTime().FindDoT(this, dotKey) != INDEX_NONE;
 }
 
 //----------------------------------------------------------REPLICATION FUNCTIONS----------------------------------------------------------
 
 bool AGameCharacter::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
 {
-	/*const ARealmPlayerController* player = Cast<ARealmPlayerController>(RealViewer);
+	if (!bUseVisionRelevancy || bAlwaysRelevant)
+		return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+
+	//spectators and anyone without a team see everything
+	const ARealmPlayerController* player = Cast<ARealmPlayerController>(RealViewer);
+	const ARealmPlayerState* ps = IsValid(player) ? Cast<ARealmPlayerState>(player->PlayerState) : nullptr;
+	if (!IsValid(ps) || ps->GetTeamIndex() < 0 || ps->GetTeamIndex() >= VISION_MAX_TEAMS)
+		return true;
+
+	const int32 viewerTeam = ps->GetTeamIndex();
+	if (viewerTeam == teamIndex || bCanEnemySee || (visibleTeamsMask & (1 << viewerTeam)) != 0)
+		return true;
 
-	if (IsValid(player) && IsValid(player->fogOfWar) && player->fogOfWar->enemySightList.Num() > 0)
-		return player->fogOfWar->enemySightList.Contains(this); //only be relevant to players who see this unit*/
+	//stay relevant for a little while after leaving sight
+	return GetWorld()->GetTimeSeconds() - teamSightLostTimes[viewerTeam] < visionRelevancyGracePeriod;
+}
 
-	return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+void AGameCharacter::SetVisibleToTeam(int32 team, bool bVisible)
+{
+	if (team < 0 || team >= VISION_MAX_TEAMS)
+		return;
+
+	const uint8 teamBit = 1 << team;
+	if (bVisible)
+		visibleTeamsMask |= teamBit;
+	else if ((visibleTeamsMask & teamBit) != 0)
+	{
+		visibleTeamsMask &= ~teamBit;
+		teamSightLostTimes[team] = GetWorld()->GetTimeSeconds();
+	}
 }
 
 void AGameCharacter::PreReplication(IRepChangedPropertyTracker & ChangedPropertyTracker)
 {
 	Super::PreReplication(ChangedPropertyTracker);
 
+	//send every hit since the last net update as one bundle
+	if (pendingHitCount > 0)
+	{
+		hitBundle.hits.Reset(pendingHitCount);
+		for (int32 i = 0; i < pendingHitCount; i++)
+			hitBundle.hits.Add(pendingHits[(pendingHitStart + i) % MAX_PENDING_HITS]);
+
+		hitBundle.bundleCounter++;
+		pendingHitStart = 0;
+		pendingHitCount = 0;
+	}
+
 	// Only replicate this property for a short duration after it changes so join in progress players don't get spammed with fx when joining late
-	DOREPLIFETIME_ACTIVE_OVERRIDE(AGameCharacter, lastTakeHitInfo, GetWorld() && GetWorld()->GetTimeSeconds() < lastTakeHitTimeTimeout);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AGameCharacter, hitBundle, GetWorld() && GetWorld()->GetTimeSeconds() < lastTakeHitTimeTimeout);
 }
 
 bool AGameCharacter::ReplicateSubobjects(class UActorChannel *Channel, class FOutBunch *Bunch, FReplicationFlags *RepFlags)
@@ -1788,5 +1890,5 @@ void AGameCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & Ou
 	DOREPLIFETIME(AGameCharacter, mods);
 	DOREPLIFETIME(AGameCharacter, bIsTargetable);
 	DOREPLIFETIME(AGameCharacter, bAutoAttackLaunching);
-	DOREPLIFETIME_CONDITION(AGameCharacter, lastTakeHitInfo, COND_Custom);
+	DOREPLIFETIME_CONDITION(AGameCharacter, hitBundle, COND_Custom);
 }
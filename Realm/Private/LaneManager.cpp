@@ -4,6 +4,7 @@
 #include "RealmObjective.h"
 #include "MinionCharacter.h"
 #include "RealmEnabler.h"
+#include "RealmGameMode.h"
 
 ALaneManager::ALaneManager(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -12,12 +13,21 @@ ALaneManager::ALaneManager(const FObjectInitializer& objectInitializer)
 
 	minionSpawnTime = 0.87f;
 	waveTime = 30.f;
+
+	poolPrewarmWaves = 2;
+	parkedMinions = 0;
+	poolRequests = 0;
+	poolHits = 0;
+	poolPeakSize = 0;
 }
 
 void ALaneManager::MatchStarted()
 {
 	if (Role == ROLE_Authority)
+	{
+		PrewarmMinionPool();
 		GetWorld()->GetTimerManager().SetTimer(waveTimer, this, &ALaneManager::StartMinionWaveSpawning, 15.f);
+	}
 }
 
 void ALaneManager::StartMinionWaveSpawning()
@@ -34,28 +44,111 @@ void ALaneManager::StartSpawningWave()
 
 void ALaneManager::SpawnNextMinion()
 {
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	FRealmSimulatorScope scope(IsValid(gm) ? &gm->GetSimulator() : nullptr, TEXT("LaneSpawning"));
+
 	if ((!bEnemyGeneratorDestroyed && waveCounter < normalWave.Num()) || (bEnemyGeneratorDestroyed && waveCounter < ultraWave.Num()))
 	{
-		AMinionCharacter* minion;
-		if (bEnemyGeneratorDestroyed)
-			minion = GetWorld()->SpawnActor<AMinionCharacter>(ultraWave[waveCounter], spawnLocation->GetActorLocation(), FRotator::ZeroRotator);
-		else
-			minion = GetWorld()->SpawnActor<AMinionCharacter>(normalWave[waveCounter], spawnLocation->GetActorLocation(), FRotator::ZeroRotator);
+		AcquireMinion(bEnemyGeneratorDestroyed ? ultraWave[waveCounter] : normalWave[waveCounter]);
+
+		waveCounter++;
+		GetWorld()->GetTimerManager().SetTimer(minionTimer, this, &ALaneManager::SpawnNextMinion, minionSpawnTime, false);
+	}
+}
+
+AMinionCharacter* ALaneManager::AcquireMinion(TSubclassOf<AMinionCharacter> minionClass)
+{
+	poolRequests++;
+
+	TArray<AMinionCharacter*>* parked = minionPool.Find(*minionClass);
+	while (parked && parked->Num() > 0)
+	{
+		AMinionCharacter* minion = parked->Pop(false);
+		parkedMinions--;
+
+		if (!IsValid(minion))
+			continue;
 
-		if (minion)
+		ARealmLaneMinionAI* minionAI = Cast<ARealmLaneMinionAI>(minion->GetController());
+		if (!IsValid(minionAI))
 		{
-			minion->spawningLane = this;
-			minion->InitCharacterStatsForLevel(spawnMinionLevel);
+			minion->Destroy();
+			continue;
+		}
+
+		poolHits++;
+		minion->ResetForReuse(spawnLocation->GetActorLocation(), spawnMinionLevel);
+		minionAI->ResetForReuse();
+
+		return minion;
+	}
+
+	return CreateMinion(minionClass);
+}
+
+AMinionCharacter* ALaneManager::CreateMinion(TSubclassOf<AMinionCharacter> minionClass)
+{
+	//prewarmed minions are all spawned on the same spot at once
+	FActorSpawnParameters spawnParams;
+	spawnParams.bNoCollisionFail = true;
 
-			minion->SetTeamIndex(teamIndex);
-			ARealmLaneMinionAI* minionAI = GetWorld()->SpawnActor<ARealmLaneMinionAI>(minion->GetActorLocation(), minion->GetActorRotation());
-			minionAI->SetLaneManager(this);
-			minionAI->Possess(minion);
+	AMinionCharacter* minion = GetWorld()->SpawnActor<AMinionCharacter>(minionClass, spawnLocation->GetActorLocation(), FRotator::ZeroRotator, spawnParams);
+	if (!minion)
+		return nullptr;
+
+	minion->spawningLane = this;
+	minion->InitCharacterStatsForLevel(spawnMinionLevel);
+
+	minion->SetTeamIndex(teamIndex);
+	ARealmLaneMinionAI* minionAI = GetWorld()->SpawnActor<ARealmLaneMinionAI>(minion->GetActorLocation(), minion->GetActorRotation());
+	minionAI->SetLaneManager(this);
+	minionAI->Possess(minion);
+
+	return minion;
+}
+
+void ALaneManager::PrewarmMinionPool()
+{
+	if (!IsValid(spawnLocation))
+		return;
+
+	//the first waves are always normal waves, ultra minions are spawned on demand
+	for (int32 i = 0; i < poolPrewarmWaves; i++)
+	{
+		for (TSubclassOf<AMinionCharacter> minionClass : normalWave)
+		{
+			AMinionCharacter* minion = CreateMinion(minionClass);
+			if (minion)
+				ReleaseMinion(minion);
 		}
+	}
+}
 
-		waveCounter++;
-		GetWorld()->GetTimerManager().SetTimer(minionTimer, this, &ALaneManager::SpawnNextMinion, minionSpawnTime, false);
+void ALaneManager::ReleaseMinion(AMinionCharacter* minion)
+{
+	if (!IsValid(minion))
+		return;
+
+	ARealmLaneMinionAI* minionAI = Cast<ARealmLaneMinionAI>(minion->GetController());
+	if (!IsValid(minionAI))
+	{
+		minion->Destroy();
+		return;
 	}
+
+	minionAI->Park();
+	minion->Park();
+
+	minionPool.FindOrAdd(minion->GetClass()).Add(minion);
+	parkedMinions++;
+	poolPeakSize = FMath::Max(poolPeakSize, parkedMinions);
+}
+
+void ALaneManager::ReportMinionPool() const
+{
+	const int32 poolMisses = poolRequests - poolHits;
+	UE_LOG(LogTemp, Log, TEXT("Minion pool lane %d team %d: %d requests, %.0f%% hit rate, %d misses, %d parked, %d peak parked"), lane, teamIndex, poolRequests,
+		poolRequests > 0 ? (float)poolHits / poolRequests * 100.f : 0.f, poolMisses, parkedMinions, poolPeakSize);
 }
 
 void ALaneManager::StopMinionWaveSpawning()
@@ -6,6 +6,7 @@
 #include "RealmPlayerState.h"
 #include "RealmForestMinionAI.h"
 #include "RealmPlayerController.h"
+#include "LaneManager.h"
 
 AMinionCharacter::AMinionCharacter(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -15,6 +16,7 @@ AMinionCharacter::AMinionCharacter(const FObjectInitializer& objectInitializer)
 	bReplicateMovement = true;
 
 	NetUpdateFrequency = 15.f;
+	poolGeneration = 0;
 }
 
 void AMinionCharacter::OnDeath(float KillingDamage, struct FDamageEvent const& DamageEvent, class APawn* InstigatingPawn, class AActor* DamageCauser, FRealmDamage& realmDamage, FDamageRecap& damageDesc)
@@ -28,7 +30,10 @@ void AMinionCharacter::OnDeath(float KillingDamage, struct FDamageEvent const& D
 		if (IsValid(GetController()))
 		{
 			GetWorldTimerManager().ClearAllTimersForObject(GetController());
-			GetController()->SetLifeSpan(2.6f);
+
+			//lane minions keep their controller so both can be reused from the pool
+			if (!IsValid(spawningLane))
+				GetController()->SetLifeSpan(2.6f);
 		}
 
 		FTimerHandle timer;
@@ -50,7 +55,70 @@ void AMinionCharacter::OnDeath(float KillingDamage, struct FDamageEvent const& D
 
 void AMinionCharacter::RealmDestroy()
 {
-	Destroy();
+	if (IsValid(spawningLane))
+		spawningLane->ReleaseMinion(this);
+	else
+		Destroy();
+}
+
+void AMinionCharacter::Park()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	StopAutoAttack();
+
+	bIsDying = true;
+	currentTarget = nullptr;
+	GetCharacterMovement()->SetMovementMode(MOVE_None);
+	SetActorEnableCollision(false);
+	SetActorHiddenInGame(true);
+
+	//nothing about a parked minion changes, so stop considering it for replication until it is reused
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AMinionCharacter::ResetForReuse(const FVector& location, int32 newLevel)
+{
+	SetNetDormancy(DORM_Awake);
+	SetActorLocation(location, false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorRotation(FRotator::ZeroRotator);
+
+	if (IsValid(statsManager))
+		statsManager->ResetStats(characterData->GetDefaultObject<UGameCharacterData>()->GetCharacterBaseStats());
+
+	level = 1;
+	skillPoints = 0;
+	experienceAmount = 0;
+	damagedSightCharacters.Reset();
+
+	Revive();
+	InitCharacterStatsForLevel(newLevel);
+
+	if (IsValid(statsManager))
+		statsManager->SetMaxHealth();
+
+	poolGeneration++;
+}
+
+void AMinionCharacter::OnRep_PoolGeneration()
+{
+	Revive();
+}
+
+void AMinionCharacter::Revive()
+{
+	bIsDying = false;
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+	SetActorEnableCollision(true);
+	SetActorHiddenInGame(false);
+
+	OnCharacterSpawned();
+}
+
+void AMinionCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AMinionCharacter, poolGeneration);
 }
 
 float AMinionCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, class AActor* DamageCauser)
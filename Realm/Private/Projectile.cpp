@@ -3,6 +3,7 @@
 #include "GameCharacter.h"
 #include "UnrealNetwork.h"
 #include "RealmPlayerController.h"
+#include "RealmGameMode.h"
 
 AProjectile::AProjectile(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -32,46 +33,182 @@ AProjectile::AProjectile(const FObjectInitializer& objectInitializer)
 	PrimaryActorTick.bCanEverTick = true;
 
 	NetUpdateFrequency = 30.f;
+
+	poolSize = 16;
+	poolGeneration = 0;
+
+	bServerSimulatedShot = true;
+	bCosmeticShot = false;
 }
 
-void AProjectile::BeginPlay()
+AProjectile* AProjectile::SpawnPooledProjectile(UObject* worldContextObject, TSubclassOf<AProjectile> projectileClass, const FVector& location, const FRotator& rotation)
 {
-	Super::BeginPlay();
+	UWorld* world = GEngine->GetWorldFromContextObject(worldContextObject);
+	if (!world)
+		return nullptr;
 
-	SetLifeSpan(25.f);
+	ARealmGameMode* gm = world->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
+		return nullptr;
+
+	return gm->GetProjectilePool().Acquire(world, projectileClass, location, rotation);
+}
+
+void AProjectile::ActivateProjectile(const FVector& location, const FRotator& rotation)
+{
+	if (IsParked())
+		poolGeneration++;
+
+	SetNetDormancy(DORM_Awake);
+	SetActorLocationAndRotation(location, rotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+	//a reused projectile starts with the same settings a freshly spawned one would have
+	const AProjectile* defaults = GetClass()->GetDefaultObject<AProjectile>();
+	damage = defaults->damage;
+	damageType = defaults->damageType;
+	hitSound = defaults->hitSound;
+	bAutoAttackProjectile = false;
+	projectileSpawner = nullptr;
+	homingTarget = nullptr;
 
-	if (IsValid(homingTarget) && !homingTarget->IsAlive())
+	ResetMovement();
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	GetWorldTimerManager().SetTimer(expireTimer, this, &AProjectile::DeactivateProjectile, 25.f);
+}
+
+void AProjectile::DeactivateProjectile()
+{
+	if (IsParked())
+		return;
+
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm) || !gm->GetProjectilePool().Release(this))
+	{
 		Destroy();
+		return;
+	}
+
+	poolGeneration++;
+	projectileSpawner = nullptr;
+	homingTarget = nullptr;
+
+	movementComponent->StopMovementImmediately();
+	movementComponent->HomingTargetComponent = nullptr;
+	movementComponent->SetComponentTickEnabled(false);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	//parked projectiles don't change, so stop considering them for replication until they are reused
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AProjectile::ResetMovement()
+{
+	const AProjectile* defaults = GetClass()->GetDefaultObject<AProjectile>();
+
+	movementComponent->SetUpdatedComponent(collisionComp);
+	movementComponent->InitialSpeed = defaults->movementComponent->InitialSpeed;
+	movementComponent->MaxSpeed = defaults->movementComponent->MaxSpeed;
+	movementComponent->bIsHomingProjectile = defaults->movementComponent->bIsHomingProjectile;
+	movementComponent->HomingTargetComponent = nullptr;
+	movementComponent->Velocity = GetActorForwardVector() * movementComponent->InitialSpeed;
+	movementComponent->SetComponentTickEnabled(true);
+}
+
+void AProjectile::OnRep_PoolGeneration()
+{
+	if (IsParked())
+	{
+		movementComponent->StopMovementImmediately();
+		movementComponent->SetComponentTickEnabled(false);
+
+		SetActorEnableCollision(false);
+		SetActorTickEnabled(false);
+	}
+	else
+	{
+		ResetMovement();
+		OnRep_HomingTarget();
+
+		SetActorEnableCollision(true);
+		SetActorTickEnabled(true);
+	}
 }
 
 void AProjectile::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	//cosmetic shots are spawned locally so they have authority, but the server decides if they hit
+	if (bCosmeticShot)
+	{
+		if (!IsValid(homingTarget) || !homingTarget->IsAlive())
+			Destroy();
+		else
+			UpdateClientVisibility();
+
+		return;
+	}
+
 	if (HasAuthority())
 	{
 		if ((movementComponent->bIsHomingProjectile && !IsValid(homingTarget)) || (movementComponent->bIsHomingProjectile && IsValid(homingTarget) && !homingTarget->IsTargetable()))
 		{
-			Destroy();
+			DeactivateProjectile();
 			return;
 		}
 
-		if ((!IsValid(projectileSpawner) || (movementComponent->bIsHomingProjectile && IsValid(homingTarget) && !homingTarget->IsAlive())) && GetWorldTimerManager().GetTimerRemaining(TimerHandle_LifeSpanExpired) <= 0.f)
+		if ((!IsValid(projectileSpawner) || (movementComponent->bIsHomingProjectile && IsValid(homingTarget) && !homingTarget->IsAlive())) && GetWorldTimerManager().GetTimerRemaining(expireTimer) > 5.f)
 		{
-			SetLifeSpan(5.f);
+			GetWorldTimerManager().SetTimer(expireTimer, this, &AProjectile::DeactivateProjectile, 5.f);
 			return;
 		}
 	}
 	else
-	{
-		//if its a homing projectile, hide if the owner is hidden unless the target is the local player
-		if (IsValid(homingTarget) && IsValid(projectileSpawner) && projectileSpawner->bHidden)
-			SetActorHiddenInGame(true);
+		UpdateClientVisibility();
+}
+
+void AProjectile::UpdateClientVisibility()
+{
+	//if its a homing projectile, hide if the owner is hidden unless the target is the local player
+	if (IsValid(homingTarget) && IsValid(projectileSpawner) && projectileSpawner->bHidden)
+		SetActorHiddenInGame(true);
 
-		ARealmPlayerController* localPC = Cast<ARealmPlayerController>(GetWorld()->GetFirstPlayerController());
-		if (bHidden && IsValid(localPC) && IsValid(localPC->GetPlayerCharacter()))
-			SetActorHiddenInGame(!(localPC->GetPlayerCharacter() == homingTarget));
+	ARealmPlayerController* localPC = Cast<ARealmPlayerController>(GetWorld()->GetFirstPlayerController());
+	if (bHidden && IsValid(localPC) && IsValid(localPC->GetPlayerCharacter()))
+		SetActorHiddenInGame(!(localPC->GetPlayerCharacter() == homingTarget));
+}
+
+void AProjectile::InitializeCosmeticShot(AGameCharacter* shotSource, AGameCharacter* shotTarget, float speed)
+{
+	if (!IsValid(shotTarget))
+	{
+		Destroy();
+		return;
 	}
+
+	//a listen server host spawns this with authority, keep it from replicating on top of the clients' own copies
+	SetReplicates(false);
+
+	bCosmeticShot = true;
+	projectileSpawner = shotSource;
+	homingTarget = shotTarget;
+
+	movementComponent->InitialSpeed = speed;
+	movementComponent->MaxSpeed = speed;
+	movementComponent->Velocity = (homingTarget->GetActorLocation() - GetActorLocation()).GetSafeNormal() * speed;
+	movementComponent->HomingTargetComponent = homingTarget->GetRootComponent();
+	movementComponent->bIsHomingProjectile = true;
+
+	SetLifeSpan(25.f);
 }
 
 void AProjectile::InitializeProjectile(const FVector& AimDir, float inDamage, TSubclassOf<UDamageType> projDamage, AGameCharacter* projSpawner /* = nullptr */, AGameCharacter* projTarget /* = nullptr */, FRealmDamage const& rdmg, float spdScale)
@@ -94,6 +231,17 @@ void AProjectile::InitializeProjectile(const FVector& AimDir, float inDamage, TS
 
 void AProjectile::OnHit(class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+	if (bCosmeticShot)
+	{
+		if (OtherActor == homingTarget)
+		{
+			ClientProjectileCollision();
+			Destroy();
+		}
+
+		return;
+	}
+
 	if (Role < ROLE_Authority)
 	{
 		ClientProjectileCollision();
@@ -112,12 +260,12 @@ void AProjectile::OnHit(class AActor* OtherActor, class UPrimitiveComponent* Oth
 		FDamageEvent damageEvent(damageType);
 		homingTarget->CharacterTakeDamage(damage, damageEvent, projectileSpawner->GetRealmController(), this, realmDamage, damageDesc);
 
-		Destroy();
+		DeactivateProjectile();
 	}
 	else if (!homingTarget)
 	{
 		AGameCharacter* gc = Cast<AGameCharacter>(OtherActor);
-		if (!IsValid(gc)) //its not a game character so we don't collide
+		if (!IsValid(gc) || !IsValid(projectileSpawner)) //its not a game character (or we haven't been launched yet) so we don't collide
 			return;
 
 		if (!damageType)
@@ -130,7 +278,7 @@ void AProjectile::OnHit(class AActor* OtherActor, class UPrimitiveComponent* Oth
 		//gc->TakeDamage(damage, damageEvent, projectileSpawner->GetRealmController(), this);
 		gc->CharacterTakeDamage(damage, damageEvent, projectileSpawner->GetRealmController(), this, realmDamage, damageDesc);
 
-		Destroy();
+		DeactivateProjectile();
 	}
 }
 
@@ -149,4 +297,5 @@ void AProjectile::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLi
 
 	DOREPLIFETIME(AProjectile, homingTarget);
 	DOREPLIFETIME(AProjectile, hitSound);
+	DOREPLIFETIME(AProjectile, poolGeneration);
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "Realm.h"
+#include "RealmAIScheduler.h"
+#include "RealmMoveController.h"
+
+FRealmAIScheduler::FRealmAIScheduler()
+: cursor(0), bUpdating(false), frameBudget(1.f), lastFrameTime(0.f), lastFrameDeferred(0), reportTime(0.0), reportFrames(0), reportUpdates(0), reportDeferred(0), reportOverBudgetFrames(0), reportInterval(30.f), timeSinceLastReport(0.f)
+{
+
+}
+
+void FRealmAIScheduler::SetFrameBudget(float newFrameBudget)
+{
+	frameBudget = FMath::Max(newFrameBudget, 0.f);
+}
+
+void FRealmAIScheduler::SetReportInterval(float newReportInterval)
+{
+	reportInterval = FMath::Max(newReportInterval, 0.f);
+}
+
+void FRealmAIScheduler::AddController(ARealmMoveController* controller, float worldTime)
+{
+	if (!IsValid(controller) || controllers.Contains(controller))
+		return;
+
+	controller->nextScheduledUpdateTime = worldTime + FMath::FRand() * controller->updateInterval;
+	controllers.Add(controller);
+}
+
+void FRealmAIScheduler::RemoveController(ARealmMoveController* controller)
+{
+	const int32 index = controllers.Find(controller);
+	if (index == INDEX_NONE)
+		return;
+
+	//a controller can remove itself from inside its own update, so leave the slot for the pass to compact
+	if (bUpdating)
+	{
+		controllers[index] = nullptr;
+		return;
+	}
+
+	controllers.RemoveAt(index);
+	if (index < cursor)
+		cursor--;
+}
+
+void FRealmAIScheduler::Update(float deltaSeconds, float worldTime)
+{
+	const double startTime = FPlatformTime::Seconds();
+	const double budgetSeconds = frameBudget / 1000.f;
+
+	int32 updates = 0;
+	int32 deferred = 0;
+	bool bOutOfBudget = false;
+	int32 resumeCursor = INDEX_NONE;
+	bUpdating = true;
+
+	const int32 controllerCount = controllers.Num();
+	for (int32 i = 0; i < controllerCount && controllers.Num() > 0; i++)
+	{
+		if (cursor >= controllers.Num())
+			cursor = 0;
+
+		ARealmMoveController* controller = controllers[cursor];
+		if (!IsValid(controller))
+		{
+			cursor++;
+			continue;
+		}
+
+		if (worldTime < controller->nextScheduledUpdateTime)
+		{
+			cursor++;
+			continue;
+		}
+
+		//count the rest of the due controllers so the report shows how far behind we are
+		if (bOutOfBudget)
+		{
+			deferred++;
+			cursor++;
+			continue;
+		}
+
+		//schedule from now rather than the old due time so a slow frame doesn't cause a burst of catch up updates
+		controller->nextScheduledUpdateTime = worldTime + controller->updateInterval;
+		controller->ScheduledUpdate();
+		updates++;
+		cursor++;
+
+		if (frameBudget > 0.f && FPlatformTime::Seconds() - startTime >= budgetSeconds)
+		{
+			bOutOfBudget = true;
+			resumeCursor = cursor;
+		}
+	}
+
+	bUpdating = false;
+
+	//start at the first controller we didn't get to next frame
+	if (resumeCursor != INDEX_NONE)
+		cursor = resumeCursor;
+
+	//drop the controllers removed or destroyed during the pass, keeping the cursor on the same controller
+	for (int32 i = controllers.Num() - 1; i >= 0; i--)
+	{
+		if (!IsValid(controllers[i]))
+		{
+			controllers.RemoveAt(i);
+			if (i < cursor)
+				cursor--;
+		}
+	}
+
+	lastFrameTime = (FPlatformTime::Seconds() - startTime) * 1000.f;
+	lastFrameDeferred = deferred;
+
+	reportTime += lastFrameTime;
+	reportFrames++;
+	reportUpdates += updates;
+	reportDeferred += deferred;
+	if (bOutOfBudget)
+		reportOverBudgetFrames++;
+
+	timeSinceLastReport += deltaSeconds;
+	if (reportInterval > 0.f && timeSinceLastReport >= reportInterval)
+		ReportBudget();
+}
+
+void FRealmAIScheduler::ReportBudget()
+{
+	if (reportFrames > 0)
+	{
+		const float averageTime = reportTime / reportFrames;
+		UE_LOG(LogTemp, Log, TEXT("AI scheduler: %d controllers, %.3f ms avg per frame (%.0f%% of %.2f ms budget), %d updates, %d deferred, %d frames over budget"),
+			controllers.Num(), averageTime, frameBudget > 0.f ? averageTime / frameBudget * 100.f : 0.f, frameBudget, reportUpdates, reportDeferred, reportOverBudgetFrames);
+	}
+
+	reportTime = 0.0;
+	reportFrames = 0;
+	reportUpdates = 0;
+	reportDeferred = 0;
+	reportOverBudgetFrames = 0;
+	timeSinceLastReport = 0.f;
+}
@@ -0,0 +1,77 @@
+#include "Realm.h"
+#include "RealmAutoAttackShots.h"
+#include "GameCharacter.h"
+#include "Projectile.h"
+
+void FRealmAutoAttackShots::FireShot(AGameCharacter* source, AGameCharacter* target, TSubclassOf<AProjectile> projectileClass, const FVector& location, float speedScale, float damage, const FRealmDamage& realmDamage, USoundCue* hitSound)
+{
+	if (!IsValid(source) || !IsValid(target) || !*projectileClass)
+		return;
+
+	const AProjectile* defaults = projectileClass->GetDefaultObject<AProjectile>();
+
+	FRealmShot shot;
+	shot.source = source;
+	shot.target = target;
+	shot.location = location;
+
+	//a max speed of 0 means no limit, so the launch speed is the initial speed
+	const UProjectileMovementComponent* movement = defaults->movementComponent;
+	const float launchSpeed = movement->MaxSpeed > 0.f ? FMath::Min(movement->InitialSpeed, movement->MaxSpeed) : movement->InitialSpeed;
+	shot.speed = launchSpeed * speedScale;
+
+	shot.hitDistance = defaults->collisionComp->GetScaledSphereRadius() + target->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	shot.timeRemaining = 25.f;
+	shot.damage = damage;
+	shot.realmDamage = realmDamage;
+	shot.damageDesc = defaults->damageDesc;
+	shot.hitSound = hitSound;
+
+	shots.Add(shot);
+
+	//clients only need enough to draw the shot, they never resolve it
+	source->AllShotFired(target, projectileClass, location, shot.speed);
+}
+
+void FRealmAutoAttackShots::Update(float deltaSeconds)
+{
+	for (int32 i = shots.Num() - 1; i >= 0; i--)
+	{
+		FRealmShot& shot = shots[i];
+		AGameCharacter* target = shot.target.Get();
+
+		shot.timeRemaining -= deltaSeconds;
+		if (!shot.source.IsValid() || !IsValid(target) || !target->IsAlive() || !target->IsTargetable() || shot.timeRemaining <= 0.f)
+		{
+			shots.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		const FVector toTarget = target->GetActorLocation() - shot.location;
+		const float distance = toTarget.Size();
+		const float step = shot.speed * deltaSeconds;
+
+		if (distance <= step + shot.hitDistance)
+		{
+			landedShots.Add(shot);
+			shots.RemoveAtSwap(i, 1, false);
+		}
+		else
+			shot.location += toTarget / distance * step;
+	}
+
+	for (FRealmShot& shot : landedShots)
+	{
+		AGameCharacter* source = shot.source.Get();
+		AGameCharacter* target = shot.target.Get();
+		if (!IsValid(source) || !IsValid(target) || !target->IsAlive())
+			continue;
+
+		target->PlayCharacterSound(shot.hitSound);
+
+		FDamageEvent damageEvent(UPhysicalDamage::StaticClass());
+		target->CharacterTakeDamage(shot.damage, damageEvent, source->GetRealmController(), source, shot.realmDamage, shot.damageDesc);
+	}
+
+	landedShots.Reset();
+}
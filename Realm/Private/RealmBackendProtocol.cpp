@@ -0,0 +1,356 @@
+#include "Realm.h"
+#include "RealmBackendProtocol.h"
+
+FString FRealmBackendString::ToString() const
+{
+	if (length <= 0)
+		return FString();
+
+	FUTF8ToTCHAR converted((const ANSICHAR*)data, length);
+	return FString(converted.Length(), converted.Get());
+}
+
+//----------------------------------------------------------WRITER----------------------------------------------------------
+
+FRealmBackendWriter::FRealmBackendWriter(TArray<uint8>& outBuffer, ERealmBackendMessage type)
+: buffer(outBuffer), frameStart(outBuffer.Num())
+{
+	//room for the length, filled in by Finish
+	buffer.AddZeroed(BACKEND_FRAME_HEADER_SIZE);
+	buffer.Add((uint8)type);
+}
+
+void FRealmBackendWriter::WriteInt(int32 value)
+{
+	const uint32 bits = (uint32)value;
+	buffer.Add(bits & 0xff);
+	buffer.Add((bits >> 8) & 0xff);
+	buffer.Add((bits >> 16) & 0xff);
+	buffer.Add((bits >> 24) & 0xff);
+}
+
+void FRealmBackendWriter::WriteString(const FString& value)
+{
+	FTCHARToUTF8 converted(*value);
+	WriteInt(converted.Length());
+	buffer.Append((const uint8*)converted.Get(), converted.Length());
+}
+
+void FRealmBackendWriter::WriteIntArray(const TArray<int32>& values)
+{
+	WriteInt(values.Num());
+	for (int32 value : values)
+		WriteInt(value);
+}
+
+void FRealmBackendWriter::WriteStringArray(const TArray<FString>& values)
+{
+	WriteInt(values.Num());
+	for (const FString& value : values)
+		WriteString(value);
+}
+
+void FRealmBackendWriter::Finish()
+{
+	const uint32 frameSize = buffer.Num() - frameStart - BACKEND_FRAME_HEADER_SIZE;
+	buffer[frameStart] = frameSize & 0xff;
+	buffer[frameStart + 1] = (frameSize >> 8) & 0xff;
+	buffer[frameStart + 2] = (frameSize >> 16) & 0xff;
+	buffer[frameStart + 3] = (frameSize >> 24) & 0xff;
+}
+
+//----------------------------------------------------------READER----------------------------------------------------------
+
+FRealmBackendReader::FRealmBackendReader(const uint8* frameData, int32 frameSize)
+: data(frameData), size(frameSize), offset(1), bError(frameSize < 1)
+{
+
+}
+
+ERealmBackendMessage FRealmBackendReader::GetType() const
+{
+	if (size < 1 || data[0] >= (uint8)ERealmBackendMessage::Max)
+		return ERealmBackendMessage::None;
+
+	return (ERealmBackendMessage)data[0];
+}
+
+bool FRealmBackendReader::CanRead(int32 amount)
+{
+	if (bError || amount < 0 || amount > size - offset)
+		bError = true;
+
+	return !bError;
+}
+
+bool FRealmBackendReader::ReadInt(int32& outValue)
+{
+	if (!CanRead(4))
+		return false;
+
+	const uint8* bytes = data + offset;
+	outValue = (int32)((uint32)bytes[0] | ((uint32)bytes[1] << 8) | ((uint32)bytes[2] << 16) | ((uint32)bytes[3] << 24));
+	offset += 4;
+	return true;
+}
+
+bool FRealmBackendReader::ReadString(FRealmBackendString& outValue)
+{
+	int32 length;
+	if (!ReadInt(length) || !CanRead(length))
+		return false;
+
+	outValue.data = data + offset;
+	outValue.length = length;
+	offset += length;
+	return true;
+}
+
+bool FRealmBackendReader::ReadIntArray(TArray<int32>& outValues)
+{
+	int32 count;
+	if (!ReadInt(count) || !CanRead(count < 0 || count > (size - offset) / 4 ? -1 : count * 4))
+		return false;
+
+	outValues.SetNumUninitialized(count);
+	for (int32 i = 0; i < count; i++)
+		ReadInt(outValues[i]);
+
+	return !bError;
+}
+
+bool FRealmBackendReader::ReadStringArray(TArray<FRealmBackendString>& outValues)
+{
+	//every string is at least its length, so a count bigger than that can't be right
+	int32 count;
+	if (!ReadInt(count) || !CanRead(count < 0 || count > (size - offset) / 4 ? -1 : count * 4))
+		return false;
+
+	outValues.SetNum(count);
+	for (int32 i = 0; i < count; i++)
+	{
+		if (!ReadString(outValues[i]))
+			return false;
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------STREAM----------------------------------------------------------
+
+FRealmBackendStream::FRealmBackendStream()
+: readOffset(0), bCorrupt(false)
+{
+
+}
+
+void FRealmBackendStream::Append(const uint8* data, int32 size)
+{
+	if (bCorrupt || size <= 0)
+		return;
+
+	//slide the unread bytes down once the popped ones take up most of the buffer
+	if (readOffset > 0 && readOffset >= buffer.Num() / 2)
+	{
+		buffer.RemoveAt(0, readOffset, false);
+		readOffset = 0;
+	}
+
+	buffer.Append(data, size);
+}
+
+bool FRealmBackendStream::PeekFrame(const uint8*& outData, int32& outSize)
+{
+	const int32 available = buffer.Num() - readOffset;
+	if (bCorrupt || available < BACKEND_FRAME_HEADER_SIZE)
+		return false;
+
+	const uint8* header = buffer.GetData() + readOffset;
+	const uint32 frameSize = (uint32)header[0] | ((uint32)header[1] << 8) | ((uint32)header[2] << 16) | ((uint32)header[3] << 24);
+	if (frameSize == 0 || frameSize > (uint32)BACKEND_MAX_FRAME_SIZE)
+	{
+		bCorrupt = true;
+		return false;
+	}
+
+	if (available < BACKEND_FRAME_HEADER_SIZE + (int32)frameSize)
+		return false;
+
+	outData = header + BACKEND_FRAME_HEADER_SIZE;
+	outSize = frameSize;
+	return true;
+}
+
+void FRealmBackendStream::PopFrame()
+{
+	const uint8* frameData;
+	int32 frameSize;
+	if (!PeekFrame(frameData, frameSize))
+		return;
+
+	readOffset += BACKEND_FRAME_HEADER_SIZE + frameSize;
+	if (readOffset == buffer.Num())
+	{
+		buffer.Reset();
+		readOffset = 0;
+	}
+}
+
+void FRealmBackendStream::Reset()
+{
+	buffer.Reset();
+	readOffset = 0;
+	bCorrupt = false;
+}
+
+//----------------------------------------------------------MESSAGES----------------------------------------------------------
+
+void FRealmBackendProtocol::EncodeEmpty(TArray<uint8>& out, ERealmBackendMessage type)
+{
+	FRealmBackendWriter writer(out, type);
+	writer.Finish();
+}
+
+void FRealmBackendProtocol::EncodeLogin(TArray<uint8>& out, const FString& username, const FString& passwordHash)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::Login);
+	writer.WriteString(username);
+	writer.WriteString(passwordHash);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeLogin(FRealmBackendReader& reader, FRealmLoginMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::Login && reader.ReadString(out.username) && reader.ReadString(out.passwordHash) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeLoginCreate(TArray<uint8>& out, const FString& username, const FString& passwordHash, const FString& email, const FString& alias)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::LoginCreate);
+	writer.WriteString(username);
+	writer.WriteString(passwordHash);
+	writer.WriteString(email);
+	writer.WriteString(alias);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeLoginCreate(FRealmBackendReader& reader, FRealmLoginCreateMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::LoginCreate && reader.ReadString(out.username) && reader.ReadString(out.passwordHash) && reader.ReadString(out.email) && reader.ReadString(out.alias) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeGetInfoUpdate(TArray<uint8>& out, const FString& userid)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::GetInfoUpdate);
+	writer.WriteString(userid);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeGetInfoUpdate(FRealmBackendReader& reader, FRealmGetInfoUpdateMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::GetInfoUpdate && reader.ReadString(out.userid) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeLoginSuccess(TArray<uint8>& out, const FString& userid, int32 experience, int32 mythosPoints, const FString& alias)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::LoginSuccess);
+	writer.WriteString(userid);
+	writer.WriteInt(experience);
+	writer.WriteInt(mythosPoints);
+	writer.WriteString(alias);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeLoginSuccess(FRealmBackendReader& reader, FRealmLoginSuccessMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::LoginSuccess && reader.ReadString(out.userid) && reader.ReadInt(out.experience) && reader.ReadInt(out.mythosPoints) && reader.ReadString(out.alias) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeCreateLoginFailure(TArray<uint8>& out, const FString& reason)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::CreateLoginFailure);
+	writer.WriteString(reason);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeCreateLoginFailure(FRealmBackendReader& reader, FRealmCreateLoginFailureMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::CreateLoginFailure && reader.ReadString(out.reason) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeUpdateInfo(TArray<uint8>& out, const FString& alias, int32 mythosPoints)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::UpdateInfo);
+	writer.WriteString(alias);
+	writer.WriteInt(mythosPoints);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeUpdateInfo(FRealmBackendReader& reader, FRealmUpdateInfoMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::UpdateInfo && reader.ReadString(out.alias) && reader.ReadInt(out.mythosPoints) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodePlayerWantsMMQueue(TArray<uint8>& out, const FString& userid, const FString& queue)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::PlayerWantsMMQueue);
+	writer.WriteString(userid);
+	writer.WriteString(queue);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodePlayerWantsMMQueue(FRealmBackendReader& reader, FRealmMMQueueMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::PlayerWantsMMQueue && reader.ReadString(out.userid) && reader.ReadString(out.queue) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodePlayerConfirmMatch(TArray<uint8>& out, const FString& userid, const FString& matchID)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::PlayerConfirmMatch);
+	writer.WriteString(userid);
+	writer.WriteString(matchID);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodePlayerConfirmMatch(FRealmBackendReader& reader, FRealmConfirmMatchMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::PlayerConfirmMatch && reader.ReadString(out.userid) && reader.ReadString(out.matchID) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeRankedGameFinished(TArray<uint8>& out, const TArray<FString>& userids, const TArray<int32>& teams, int32 winningTeam)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::RankedGameFinished);
+	writer.WriteStringArray(userids);
+	writer.WriteIntArray(teams);
+	writer.WriteInt(winningTeam);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeRankedGameFinished(FRealmBackendReader& reader, FRealmRankedGameFinishedMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::RankedGameFinished && reader.ReadStringArray(out.userids) && reader.ReadIntArray(out.teams) && reader.ReadInt(out.winningTeam) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeFoundMatch(TArray<uint8>& out, const FString& matchID)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::FoundMatch);
+	writer.WriteString(matchID);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeFoundMatch(FRealmBackendReader& reader, FRealmFoundMatchMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::FoundMatch && reader.ReadString(out.matchID) && reader.IsComplete();
+}
+
+void FRealmBackendProtocol::EncodeFoundMatchConfirmed(TArray<uint8>& out, const FString& matchAddress)
+{
+	FRealmBackendWriter writer(out, ERealmBackendMessage::FoundMatchConfirmed);
+	writer.WriteString(matchAddress);
+	writer.Finish();
+}
+
+bool FRealmBackendProtocol::DecodeFoundMatchConfirmed(FRealmBackendReader& reader, FRealmFoundMatchConfirmedMessage& out)
+{
+	return reader.GetType() == ERealmBackendMessage::FoundMatchConfirmed && reader.ReadString(out.matchAddress) && reader.IsComplete();
+}
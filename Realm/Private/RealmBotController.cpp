@@ -1,8 +1,68 @@
 #include "Realm.h"
 #include "RealmBotController.h"
+#include "GameCharacter.h"
+#include "RealmObjective.h"
 
 ARealmBotController::ARealmBotController(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer)
 {
 	bWantsPlayerState = true;
+	updateInterval = 0.5f;
+}
+
+void ARealmBotController::ScheduledUpdate()
+{
+	AGameCharacter* gc = Cast<AGameCharacter>(GetCharacter());
+	if (!IsValid(gc) || !gc->IsAlive())
+		return;
+
+	AGameCharacter* target = gc->GetCurrentTarget();
+	if (!IsValid(target) || !target->IsAlive() || !target->IsTargetable())
+	{
+		NeedsNewCommand();
+		target = gc->GetCurrentTarget();
+	}
+
+	if (!IsValid(target) || !target->IsAlive())
+	{
+		if (!IsValid(objectiveTarget) || !objectiveTarget->IsAlive())
+			objectiveTarget = FindObjectiveTarget();
+
+		if (IsValid(objectiveTarget))
+			MoveToActor(objectiveTarget, gc->GetCurrentValueForStat(EStat::ES_AARange));
+
+		return;
+	}
+
+	const float aaRange = gc->GetCurrentValueForStat(EStat::ES_AARange);
+	if ((target->GetActorLocation() - gc->GetActorLocation()).SizeSquared2D() > FMath::Square(aaRange))
+		MoveToActor(target, aaRange);
+	else
+		gc->StartAutoAttack();
+}
+
+ARealmObjective* ARealmBotController::FindObjectiveTarget() const
+{
+	AGameCharacter* gc = Cast<AGameCharacter>(GetCharacter());
+	if (!IsValid(gc))
+		return nullptr;
+
+	ARealmObjective* closest = nullptr;
+	float closestDistSq = MAX_FLT;
+
+	for (TActorIterator<ARealmObjective> objitr(GetWorld()); objitr; ++objitr)
+	{
+		ARealmObjective* objective = *objitr;
+		if (!IsValid(objective) || !objective->IsAlive() || objective->GetTeamIndex() == gc->GetTeamIndex())
+			continue;
+
+		const float distSq = (objective->GetActorLocation() - gc->GetActorLocation()).SizeSquared2D();
+		if (distSq < closestDistSq)
+		{
+			closest = objective;
+			closestDistSq = distSq;
+		}
+	}
+
+	return closest;
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "Realm.h"
+#include "RealmCharacterHash.h"
+#include "GameCharacter.h"
+
+bool FRealmCharacterFilter::Matches(const AGameCharacter* gc) const
+{
+	if (!IsValid(gc) || gc == ignoredCharacter)
+		return false;
+
+	if (bAliveOnly && !gc->IsAlive())
+		return false;
+
+	const int32 gcTeam = gc->GetTeamIndex();
+	if ((team != INDEX_NONE && gcTeam != team) || (excludedTeam != INDEX_NONE && gcTeam == excludedTeam))
+		return false;
+
+	if ((characterClass && !gc->IsA(characterClass)) || (excludedClass && gc->IsA(excludedClass)))
+		return false;
+
+	return true;
+}
+
+FRealmCharacterHash::FRealmCharacterHash()
+: cellSize(500.f)
+{
+
+}
+
+void FRealmCharacterHash::SetCellSize(float newCellSize)
+{
+	cellSize = FMath::Max(newCellSize, 1.f);
+
+	//characters placed in the level can register before the cell size is known, so rebucket anything already in the hash
+	teamCells.Empty();
+	for (FHashEntry& entry : entries)
+	{
+		int32 x, y;
+		GetCell(entry.character->GetActorLocation(), x, y);
+		entry.cellKey = MakeCellKey(x, y);
+		AddToBucket(entry.character, entry.team, entry.cellKey);
+	}
+}
+
+void FRealmCharacterHash::AddToBucket(AGameCharacter* gc, int32 team, int64 cellKey)
+{
+	teamCells.FindOrAdd(team).FindOrAdd(cellKey).Add(gc);
+}
+
+void FRealmCharacterHash::RemoveFromBucket(AGameCharacter* gc, int32 team, int64 cellKey)
+{
+	TMap<int64, TArray<AGameCharacter*> >* cells = teamCells.Find(team);
+	if (!cells)
+		return;
+
+	TArray<AGameCharacter*>* bucket = cells->Find(cellKey);
+	if (!bucket)
+		return;
+
+	bucket->RemoveSingleSwap(gc);
+	if (bucket->Num() == 0)
+		cells->Remove(cellKey);
+}
+
+void FRealmCharacterHash::AddCharacter(AGameCharacter* gc)
+{
+	if (!IsValid(gc) || entryIndices.Contains(gc))
+		return;
+
+	int32 x, y;
+	GetCell(gc->GetActorLocation(), x, y);
+
+	FHashEntry entry;
+	entry.character = gc;
+	entry.team = gc->GetTeamIndex();
+	entry.cellKey = MakeCellKey(x, y);
+
+	entryIndices.Add(gc, entries.Add(entry));
+	AddToBucket(gc, entry.team, entry.cellKey);
+}
+
+void FRealmCharacterHash::RemoveCharacter(AGameCharacter* gc)
+{
+	int32 index;
+	if (!entryIndices.RemoveAndCopyValue(gc, index))
+		return;
+
+	RemoveFromBucket(gc, entries[index].team, entries[index].cellKey);
+
+	//keep the entries packed, the last entry takes the removed one's place
+	entries.RemoveAtSwap(index);
+	if (entries.IsValidIndex(index))
+		entryIndices.Add(entries[index].character, index);
+}
+
+void FRealmCharacterHash::Update()
+{
+	for (int32 i = entries.Num() - 1; i >= 0; i--)
+	{
+		FHashEntry& entry = entries[i];
+		if (!IsValid(entry.character))
+		{
+			RemoveCharacter(entry.character);
+			continue;
+		}
+
+		int32 x, y;
+		GetCell(entry.character->GetActorLocation(), x, y);
+
+		//most characters stay in the same cell from frame to frame, only move the ones that left it
+		const int64 newCellKey = MakeCellKey(x, y);
+		const int32 newTeam = entry.character->GetTeamIndex();
+		if (newCellKey == entry.cellKey && newTeam == entry.team)
+			continue;
+
+		RemoveFromBucket(entry.character, entry.team, entry.cellKey);
+		entry.cellKey = newCellKey;
+		entry.team = newTeam;
+		AddToBucket(entry.character, entry.team, entry.cellKey);
+	}
+}
+
+void FRealmCharacterHash::QueryRadius(const FVector& center, float radius, const FRealmCharacterFilter& filter, TArray<AGameCharacter*>& outCharacters) const
+{
+	int32 minX, minY, maxX, maxY;
+	GetCell(center - FVector(radius, radius, 0.f), minX, minY);
+	GetCell(center + FVector(radius, radius, 0.f), maxX, maxY);
+
+	const float radiusSquared = radius * radius;
+
+	for (const auto& teamPair : teamCells)
+	{
+		//skip whole teams the filter can't match before touching any cells
+		if ((filter.team != INDEX_NONE && teamPair.Key != filter.team) || (filter.excludedTeam != INDEX_NONE && teamPair.Key == filter.excludedTeam))
+			continue;
+
+		for (int32 y = minY; y <= maxY; y++)
+		{
+			for (int32 x = minX; x <= maxX; x++)
+			{
+				const TArray<AGameCharacter*>* bucket = teamPair.Value.Find(MakeCellKey(x, y));
+				if (!bucket)
+					continue;
+
+				for (AGameCharacter* gc : *bucket)
+				{
+					if (FVector::DistSquaredXY(gc->GetActorLocation(), center) <= radiusSquared && filter.Matches(gc))
+						outCharacters.Add(gc);
+				}
+			}
+		}
+	}
+}
+
+void FRealmCharacterHash::QueryNearest(const FVector& center, float radius, int32 count, const FRealmCharacterFilter& filter, TArray<AGameCharacter*>& outCharacters) const
+{
+	TArray<AGameCharacter*> candidates;
+	QueryRadius(center, radius, filter, candidates);
+
+	candidates.Sort([&center](const AGameCharacter& a, const AGameCharacter& b)
+	{
+		return FVector::DistSquaredXY(a.GetActorLocation(), center) < FVector::DistSquaredXY(b.GetActorLocation(), center);
+	});
+
+	if (candidates.Num() > count)
+		candidates.SetNum(count);
+
+	outCharacters.Append(candidates);
+}
+
+AGameCharacter* FRealmCharacterHash::FindNearest(const FVector& center, float radius, const FRealmCharacterFilter& filter) const
+{
+	TArray<AGameCharacter*> candidates;
+	QueryRadius(center, radius, filter, candidates);
+
+	AGameCharacter* nearest = nullptr;
+	float nearestDistSquared = MAX_FLT;
+
+	for (AGameCharacter* gc : candidates)
+	{
+		const float distSquared = FVector::DistSquaredXY(gc->GetActorLocation(), center);
+		if (distSquared < nearestDistSquared)
+		{
+			nearest = gc;
+			nearestDistSquared = distSquared;
+		}
+	}
+
+	return nearest;
+}
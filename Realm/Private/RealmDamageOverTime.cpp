@@ -0,0 +1,149 @@
+#include "Realm.h"
+#include "RealmDamageOverTime.h"
+#include "GameCharacter.h"
+
+FRealmDamageOverTime::FRealmDamageOverTime()
+: nextHandle(0), lastFrameTicks(0)
+{
+
+}
+
+int32 FRealmDamageOverTime::ApplyDoT(FDamageOverTime& dot, EDoTStackPolicy stackPolicy)
+{
+	AGameCharacter* target = dot.target.Get();
+	if (!IsValid(target) || dot.tickCount <= 0)
+		return INDEX_NONE;
+
+	if (stackPolicy != EDoTStackPolicy::DSP_Stack)
+	{
+		const int32 existing = FindDoT(target, dot.dotKey);
+		if (existing != INDEX_NONE)
+		{
+			//reset dots if they already exist
+			if (stackPolicy == EDoTStackPolicy::DSP_Refresh)
+			{
+				FDamageOverTime& existingDoT = dots[handleIndices.FindChecked(existing)];
+				existingDoT.ticksRemaining = existingDoT.tickCount;
+			}
+
+			return existing;
+		}
+	}
+
+	const float worldTime = target->GetWorld()->GetTimeSeconds();
+
+	dot.handle = nextHandle++;
+	dot.ticksRemaining = dot.tickCount;
+	dot.nextTickTime = worldTime;
+
+	handleIndices.Add(dot.handle, dots.Add(dot));
+	target->dotHandles.Add(dot.handle);
+
+	//the first tick lands as soon as the dot is applied
+	TickDoT(dot.handle);
+	return dot.handle;
+}
+
+int32 FRealmDamageOverTime::FindDoT(const AGameCharacter* target, const FString& dotKey) const
+{
+	if (!IsValid(target))
+		return INDEX_NONE;
+
+	for (int32 handle : target->dotHandles)
+	{
+		const int32* index = handleIndices.Find(handle);
+		if (index && dots[*index].dotKey == dotKey)
+			return handle;
+	}
+
+	return INDEX_NONE;
+}
+
+void FRealmDamageOverTime::RemoveDoT(int32 handle)
+{
+	const int32* index = handleIndices.Find(handle);
+	if (index)
+		RemoveAt(*index);
+}
+
+void FRealmDamageOverTime::RemoveTarget(AGameCharacter* target)
+{
+	if (!IsValid(target))
+		return;
+
+	while (target->dotHandles.Num() > 0)
+	{
+		const int32 handle = target->dotHandles.Last();
+		const int32* index = handleIndices.Find(handle);
+		if (index)
+			RemoveAt(*index);
+		else
+			target->dotHandles.Pop();
+	}
+}
+
+void FRealmDamageOverTime::RemoveAt(int32 index)
+{
+	const FDamageOverTime& dot = dots[index];
+
+	AGameCharacter* target = dot.target.Get();
+	if (target)
+		target->dotHandles.RemoveSingleSwap(dot.handle);
+
+	handleIndices.Remove(dot.handle);
+	dots.RemoveAtSwap(index);
+
+	if (index < dots.Num())
+		handleIndices.Add(dots[index].handle, index);
+}
+
+void FRealmDamageOverTime::TickDoT(int32 handle)
+{
+	const int32* index = handleIndices.Find(handle);
+	if (!index)
+		return;
+
+	//copy the dot since the damage can add or remove dots and move the array
+	const FDamageOverTime dot = dots[*index];
+
+	AGameCharacter* target = dot.target.Get();
+	if (!IsValid(target) || !target->IsAlive())
+	{
+		RemoveAt(*index);
+		return;
+	}
+
+	//step from the old due time so a long frame doesn't stretch the dot out
+	FDamageOverTime& scheduledDoT = dots[*index];
+	scheduledDoT.ticksRemaining--;
+	scheduledDoT.nextTickTime += scheduledDoT.tickInterval;
+
+	if (scheduledDoT.ticksRemaining <= 0)
+		RemoveAt(*index);
+
+	target->DamageOverTimeTick(dot);
+	lastFrameTicks++;
+}
+
+void FRealmDamageOverTime::Update(float worldTime)
+{
+	lastFrameTicks = 0;
+	dueHandles.Reset();
+
+	//walk backwards so dropping a dot only swaps in one we've already looked at
+	for (int32 i = dots.Num() - 1; i >= 0; i--)
+	{
+		const FDamageOverTime& dot = dots[i];
+		if (!dot.target.IsValid() || !dot.target->IsAlive())
+		{
+			RemoveAt(i);
+			continue;
+		}
+
+		if (worldTime >= dot.nextTickTime)
+			dueHandles.Add(dot.handle);
+	}
+
+	for (int32 handle : dueHandles)
+		TickDoT(handle);
+}
@@ -1,6 +1,7 @@
 #include "Realm.h"
 #include "RealmEQSGenerator_CharactersOfClass.h"
 #include "GameCharacter.h"
+#include "RealmGameMode.h"
 #include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_Point.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_Actor.h"
@@ -28,13 +29,20 @@ void UEnvQueryGenerator_CharacterOfClass::GenerateItems(FEnvQueryInstance& Query
 		return;
 	}
 
-	const float RadiusSq = FMath::Square(RadiusValue);
+	ARealmGameMode* gm = World->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
+		return;
 
-	for (TActorIterator<AGameCharacter> ItActor = TActorIterator<AGameCharacter>(World, SearchedActorClass); ItActor; ++ItActor)
-	{
-		if (FVector::DistSquared(actor->GetActorLocation(), ItActor->GetActorLocation()) < RadiusSq && actor != *ItActor && actor->GetTeamIndex() != (*ItActor)->GetTeamIndex() && (*ItActor)->IsAlive())
-			QueryInstance.AddItemData<UEnvQueryItemType_Actor>(*ItActor);
-	}
+	FRealmCharacterFilter filter;
+	filter.excludedTeam = actor->GetTeamIndex();
+	filter.characterClass = SearchedActorClass;
+	filter.ignoredCharacter = actor;
+
+	TArray<AGameCharacter*> characters;
+	gm->GetCharacterHash().QueryRadius(actor->GetActorLocation(), RadiusValue, filter, characters);
+
+	for (AGameCharacter* gc : characters)
+		QueryInstance.AddItemData<UEnvQueryItemType_Actor>(gc);
 }
 
 FText UEnvQueryGenerator_CharacterOfClass::GetDescriptionTitle() const
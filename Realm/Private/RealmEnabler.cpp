@@ -3,14 +3,23 @@
 #include "RealmPlayerController.h"
 #include "RealmGameMode.h"
 #include "PlayerCharacter.h"
-#include "Effect.h"
 
 #define LOCTEXT_NAMESPACE "Realm" 
 
 ARealmEnabler::ARealmEnabler(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	//effect descriptions
+	enablerAuraEffect.uiName = LOCTEXT("enablereffect", "Enabler Protection Aura");
+	enablerAuraEffect.description = LOCTEXT("enablereffectdesc", "This unit is under protection from their Enabler and has increased Health and Flare regeneration.");
+	enablerAuraEffect.keyName = "enablerprotection";
+	enablerAuraEffect.bCanBeInflictedMultipleTimes = false;
+
+	//effect stat changes
+	enablerAuraEffect.stats.AddUnique(EStat::ES_HPRegen);
+	enablerAuraEffect.stats.AddUnique(EStat::ES_FlareRegen);
+	enablerAuraEffect.amounts.Add(50.f);
+	enablerAuraEffect.amounts.Add(50.f);
 }
 
 void ARealmEnabler::PlayerOpenedStore(ARealmPlayerController* pc)
@@ -46,20 +55,6 @@ void ARealmEnabler::OnTargetsUpdate()
 		}
 		else if (!protectedPlayers.Contains(pc) && protectedPlayers.AddUnique(pc) >= 0)
 		{
-			enablerAuraEffect = GetWorld()->SpawnActor<AEffect>(AEffect::StaticClass());
-
-			//effect descriptions
-			enablerAuraEffect->uiName = LOCTEXT("enablereffect", "Enabler Protection Aura");
-			enablerAuraEffect->description = LOCTEXT("enablereffectdesc", "This unit is under protection from their Enabler and has increased Health and Flare regeneration.");
-			enablerAuraEffect->keyName = "enablerprotection";
-			enablerAuraEffect->bCanBeInflictedMultipleTimes = false;
-
-			//effect stat changes
-			enablerAuraEffect->stats.AddUnique(EStat::ES_HPRegen);
-			enablerAuraEffect->stats.AddUnique(EStat::ES_FlareRegen);
-			enablerAuraEffect->amounts.Add(50.f);
-			enablerAuraEffect->amounts.Add(50.f);
-
 			pc->GetStatsManager()->AddCreatedEffect(enablerAuraEffect);
 		}
 	}
@@ -72,9 +67,7 @@ void ARealmEnabler::EnablerEffectFinished(AGameCharacter* gc)
 		UStatsManager* sm = gc->GetStatsManager();
 		if (IsValid(sm))
 		{
-			AEffect* effect = sm->GetEffect("enablerprotection");
-			if (IsValid(effect))
-				sm->EffectFinished(effect->keyName);
+			sm->EffectFinished(enablerAuraEffect.keyName);
 		}
 	}
 }
@@ -14,7 +14,7 @@ void ARealmEnablerShieldGenerator::OnDeath(float KillingDamage, struct FDamageEv
 	if (Role == ROLE_Authority)
 	{
 		if (IsValid(shield) && shield->IsAlive())
-			shield->GetStatsManager()->bonusStats[(uint8)EStat::ES_HP] -= 5000.f;
+			shield->GetStatsManager()->AddBonusStat(EStat::ES_HP, -5000.f);
 	}
 
 	GetWorldTimerManager().SetTimer(respawnTimer, this, &ARealmEnablerShieldGenerator::Respawn, 45.f);
@@ -25,7 +25,7 @@ void ARealmEnablerShieldGenerator::Respawn()
 	if (Role == ROLE_Authority)
 	{
 		if (IsValid(shield) && shield->IsAlive())
-			shield->GetStatsManager()->bonusStats[(uint8)EStat::ES_HP] += 5000.f;
+			shield->GetStatsManager()->AddBonusStat(EStat::ES_HP, 5000.f);
 	}
 
 	bIsDying = false;
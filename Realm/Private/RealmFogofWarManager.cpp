@@ -3,61 +3,179 @@
 #include "GameCharacter.h"
 #include "PlayerCharacter.h"
 #include "RealmPlayerController.h"
+#include "RealmGameMode.h"
 #include "UnrealNetwork.h"
 
 URealmFogofWarManager::URealmFogofWarManager(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	enemySightList.owner = this;
+}
+
+void FRealmSightEntry::PreReplicatedRemove(const FRealmSightList& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.owner))
+		InArraySerializer.owner->OnCharacterSightChanged(character, false);
+}
+
+void FRealmSightEntry::PostReplicatedAdd(const FRealmSightList& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.owner))
+		InArraySerializer.owner->OnCharacterSightChanged(character, true);
+}
+
+void FRealmSightEntry::PostReplicatedChange(const FRealmSightList& InArraySerializer)
+{
+	//the character reference may only resolve after the entry was added
+	if (IsValid(InArraySerializer.owner))
+		InArraySerializer.owner->OnCharacterSightChanged(character, true);
 }
 
 void URealmFogofWarManager::StartCalculatingVisibility()
 {
-	if (IsValid(playerOwner) && playerOwner->HasAuthority())
-		playerOwner->GetWorldTimerManager().SetTimer(visibilityTimer, this, &URealmFogofWarManager::CalculateTeamVisibility, (0.15f), true);
-	else if (IsValid(gameOwner))
+	if (IsValid(gameOwner))
 		gameOwner->GetWorldTimerManager().SetTimer(visibilityTimer, this, &URealmFogofWarManager::CalculateTeamVisibility, (0.15f), true);
 }
 
 void URealmFogofWarManager::CalculateTeamVisibility()
 {
-	if ((!IsValid(playerOwner) && !IsValid(gameOwner)) || !IsValid(this) || !IsValidLowLevelFast())
+	if (!IsValid(gameOwner) || !IsValid(this) || !IsValidLowLevelFast())
+		return;
+
+	UWorld* gameWorld = gameOwner->GetWorld();
+
+	ARealmGameMode* gm = gameWorld->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm) || !gm->GetVisionGrid().IsInitialized())
 		return;
 
-	teamCharacters.Empty();
-	enemySightList.Empty();
+	FRealmSimulatorScope scope(&gm->GetSimulator(), TEXT("FogOfWar"));
+
+	FRealmVisibilityGrid& visionGrid = gm->GetVisionGrid();
 
-	UWorld* gameWorld = IsValid(playerOwner) ? playerOwner->GetWorld() : gameOwner->GetWorld();
+	visibilityPass++;
+	teamCharacters.Reset();
+
+	TArray<AGameCharacter*> enemyCharacters;
+	TSet<AGameCharacter*> combatRevealed;
 
 	//get which characters are on our team
 	for (TActorIterator<AGameCharacter> chr(gameWorld); chr; ++chr)
 	{
 		AGameCharacter* gc = *chr;
-		if (IsValid(gc) && gc->GetTeamIndex() == teamIndex && gc->IsAlive())
-			teamCharacters.AddUnique(gc);
+		if (!IsValid(gc))
+			continue;
 
-		if (IsValid(gc) && gc->GetTeamIndex() == teamIndex) //always have sight of friendly units and the last unit to do recent damage to them
+		if (gc->GetTeamIndex() != teamIndex)
 		{
-			enemySightList.AddUnique(gc);
-			if (IsValid(gc->lastDamagingCharacter))
-				enemySightList.AddUnique(gc->lastDamagingCharacter);
+			enemyCharacters.Add(gc);
+			continue;
+		}
+
+		//only units that moved into a new cell or changed their sight radius redo their footprint
+		gc->CalculateVisibility(visionGrid);
+
+		if (gc->IsAlive())
+			teamCharacters.Add(gc);
 
-			for (auto& elem : gc->damagedSightCharacters)
-				enemySightList.AddUnique(elem.Value);
+		//always have sight of friendly units and the last unit to do recent damage to them
+		SetCharacterVisible(gc, true);
+		gc->GatherCombatReveals(gameWorld->GetTimeSeconds(), combatRevealed);
+	}
+
+	const uint32 visionGeneration = visionGrid.GetTeamGeneration(teamIndex);
+	const bool bVisionChanged = visionGeneration != lastVisionGeneration;
+	lastVisionGeneration = visionGeneration;
+
+	for (AGameCharacter* gc : enemyCharacters)
+	{
+		FRealmEnemyVisionState& state = enemyVisionStates.FindOrAdd(gc);
+		state.lastPass = visibilityPass;
+
+		//enemies only need testing again if they moved to another cell or our vision changed
+		int32 cellX, cellY;
+		const bool bInGrid = visionGrid.WorldToCell(gc->GetActorLocation(), cellX, cellY);
+		if (bVisionChanged || cellX != state.cellX || cellY != state.cellY)
+		{
+			state.cellX = cellX;
+			state.cellY = cellY;
+			state.bGridVisible = bInGrid && visionGrid.IsLocationVisibleToTeam(teamIndex, gc->GetActorLocation());
 		}
+
+		SetCharacterVisible(gc, state.bGridVisible || combatRevealed.Contains(gc));
+	}
+
+	//drop anything that has left the game since the last pass
+	for (auto itr = enemyVisionStates.CreateIterator(); itr; ++itr)
+	{
+		if (itr.Value().lastPass != visibilityPass || !itr.Key().IsValid())
+			itr.RemoveCurrent();
 	}
-	/*for (TActorIterator<APlayerCharacter> chr(GetWorld()); chr; ++chr)
+
+	teamPlayers.RemoveAll([](ARealmPlayerController* player) { return !IsValid(player) || !IsValid(player->fogOfWar); });
+
+	RemoveInvalidSightEntries();
+	for (ARealmPlayerController* player : teamPlayers)
+		player->fogOfWar->RemoveInvalidSightEntries();
+}
+
+void URealmFogofWarManager::RemoveInvalidSightEntries()
+{
+	for (auto itr = sightSet.CreateIterator(); itr; ++itr)
 	{
-		APlayerCharacter* gc = *chr;
-		if (IsValid(gc) && gc->GetTeamIndex() == teamIndex && gc->IsAlive())
-			teamCharacters.AddUnique(gc);
-	}*/
+		if (!itr->IsValid())
+			itr.RemoveCurrent();
+	}
 
-	//go through all of the players and get their visibility data. this data results in a list of enemy teams that can see that specific unit and replicates to all clients
-	for (int32 i = 0; i < teamCharacters.Num(); i++)
+	for (int32 i = enemySightList.items.Num() - 1; i >= 0; i--)
 	{
-		//get their sight data
-		teamCharacters[i]->CalculateVisibility(enemySightList);
+		if (!IsValid(enemySightList.items[i].character))
+		{
+			enemySightList.items.RemoveAtSwap(i);
+			enemySightList.MarkArrayDirty();
+		}
+	}
+}
+
+void URealmFogofWarManager::SetCharacterVisible(AGameCharacter* gc, bool bVisible)
+{
+	if (bVisible == sightSet.Contains(gc))
+		return;
+
+	gc->SetVisibleToTeam(teamIndex, bVisible);
+	UpdateSightList(gc, bVisible);
+
+	//every player on the team gets the same change
+	for (ARealmPlayerController* player : teamPlayers)
+	{
+		if (IsValid(player) && IsValid(player->fogOfWar))
+			player->fogOfWar->UpdateSightList(gc, bVisible);
+	}
+}
+
+void URealmFogofWarManager::UpdateSightList(AGameCharacter* gc, bool bVisible)
+{
+	if (bVisible == sightSet.Contains(gc))
+		return;
+
+	//only the entries that changed get sent to the clients
+	if (bVisible)
+	{
+		sightSet.Add(gc);
+
+		FRealmSightEntry& entry = enemySightList.items[enemySightList.items.AddDefaulted()];
+		entry.character = gc;
+		enemySightList.MarkItemDirty(entry);
+	}
+	else
+	{
+		sightSet.Remove(gc);
+
+		const int32 index = enemySightList.items.IndexOfByPredicate([gc](const FRealmSightEntry& entry) { return entry.character == gc; });
+		if (index != INDEX_NONE)
+		{
+			enemySightList.items.RemoveAtSwap(index);
+			enemySightList.MarkArrayDirty();
+		}
 	}
 }
 
@@ -75,28 +193,62 @@ void URealmFogofWarManager::RemoveCharacterFromManager(AGameCharacter* oldCharac
 
 void URealmFogofWarManager::AddPlayerToManager(ARealmPlayerController* newPlayer)
 {
-	//if (IsValid(newPlayer))
-		//teamPlayers.AddUnique(newPlayer);
+	if (!IsValid(newPlayer) || !IsValid(newPlayer->fogOfWar) || teamPlayers.Contains(newPlayer))
+		return;
+
+	teamPlayers.Add(newPlayer);
+
+	//bring the player up to date with everything the team can already see
+	for (const TWeakObjectPtr<AGameCharacter>& gc : sightSet)
+	{
+		if (gc.IsValid())
+			newPlayer->fogOfWar->UpdateSightList(gc.Get(), true);
+	}
 }
 
-void URealmFogofWarManager::OnRep_EnemySightList()
+void URealmFogofWarManager::OnCharacterSightChanged(AGameCharacter* gc, bool bVisible)
 {
 	if (!IsValid(playerOwner) || !IsValid(this) || !IsValidLowLevelFast())
 		return;
 
-	for (TActorIterator<AGameCharacter> chr(playerOwner->GetWorld()); chr; ++chr)
+	if (IsValid(gc))
 	{
-		AGameCharacter* gc = *chr;
-		if (!IsValid(gc))
-			continue;
+		if (bVisible)
+			sightSet.Add(gc);
+		else
+			sightSet.Remove(gc);
+	}
 
-		gc->SetActorHiddenInGame(!enemySightList.Contains(gc));
-		TArray<AActor*> attached;
-		gc->GetAttachedActors(attached);
+	//the first update has to hide everything we can't see, after that only the changed characters need updating
+	if (!bAppliedInitialSight)
+	{
+		bAppliedInitialSight = true;
 
-		for (AActor* attachee : attached)
-			attachee->SetActorHiddenInGame(!enemySightList.Contains(gc));
+		for (TActorIterator<AGameCharacter> chr(playerOwner->GetWorld()); chr; ++chr)
+		{
+			if (IsValid(*chr))
+				ApplyCharacterSight(*chr, sightSet.Contains(*chr));
+		}
 	}
+	else if (IsValid(gc))
+		ApplyCharacterSight(gc, bVisible);
+}
+
+void URealmFogofWarManager::InitializeCharacterSight(AGameCharacter* gc)
+{
+	if (bAppliedInitialSight && IsValid(gc))
+		ApplyCharacterSight(gc, sightSet.Contains(gc));
+}
+
+void URealmFogofWarManager::ApplyCharacterSight(AGameCharacter* gc, bool bVisible)
+{
+	gc->SetActorHiddenInGame(!bVisible);
+
+	TArray<AActor*> attached;
+	gc->GetAttachedActors(attached);
+
+	for (AActor* attachee : attached)
+		attachee->SetActorHiddenInGame(!bVisible);
 }
 
 void URealmFogofWarManager::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
@@ -4,7 +4,7 @@
 ARealmForestMinionAI::ARealmForestMinionAI(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	updateInterval = 0.8f;
 }
 
 void ARealmForestMinionAI::Possess(APawn* InPawn)
@@ -18,9 +18,11 @@ void ARealmForestMinionAI::Possess(APawn* InPawn)
 	mc->GetStatsManager()->SetMaxHealth();
 
 	minionCharacter = mc;
+}
 
-	FTimerHandle f;
-	GetWorldTimerManager().SetTimer(f, this, &ARealmForestMinionAI::ReevaluateTargets, 0.8f, true);
+void ARealmForestMinionAI::ScheduledUpdate()
+{
+	ReevaluateTargets();
 }
 
 void ARealmForestMinionAI::CharacterTookDamage(AGameCharacter* damageCauser)
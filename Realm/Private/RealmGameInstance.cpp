@@ -6,7 +6,29 @@
 URealmGameInstance::URealmGameInstance(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	socketPollBudget = 2.f;
+
+	messageLatencyTotal = 0.0;
+	messageLatencyPeak = 0.0;
+	messagesHandled = 0;
+	pollsOverBudget = 0;
+	latencyReportStartTime = 0.0;
+
+	backendHost = TEXT("mythosrealm.ddns.net");
+	loginPort = 3308;
+	multiplayerPort = 3310;
+	backendAddressTTL = 300.f;
+	backendConnectTimeout = 10.f;
+
+	pendingResolve = nullptr;
+	connectingLoginSocket = nullptr;
+	connectingMultiplayerSocket = nullptr;
+	loginConnectStartTime = 0.0;
+	multiplayerConnectStartTime = 0.0;
+	cachedBackendIp = 0;
+	cachedBackendIpTime = 0.0;
+	bLoginConnectPending = false;
+	bMultiplayerConnectPending = false;
 }
 
 URealmGameInstance::~URealmGameInstance()
@@ -16,145 +38,454 @@ URealmGameInstance::~URealmGameInstance()
 
 	if (multiplayerSocketThread)
 	multiplayerSocketThread->EnsureCompletion();
+
+	//a lookup that is still running can't be deleted, leave it rather than hold up shutdown on it
+	if (pendingResolve && pendingResolve->IsComplete())
+		delete pendingResolve;
+	pendingResolve = nullptr;
+
+	if (connectingLoginSocket)
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(connectingLoginSocket);
+	if (connectingMultiplayerSocket)
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(connectingMultiplayerSocket);
 }
 
-FString URealmGameInstance::StringFromBinaryArray(const TArray<uint8>& BinaryArray)
+void URealmGameInstance::Init()
 {
-	//Create a string from a byte array!
-	std::string cstr(reinterpret_cast<const char*>(BinaryArray.GetData()), BinaryArray.Num());
-	return FString(cstr.c_str());
+	Super::Init();
+
+	//let tests point the game at a local backend
+	const TCHAR* commandLine = FCommandLine::Get();
+	FParse::Value(commandLine, TEXT("backendhost="), backendHost);
+	FParse::Value(commandLine, TEXT("loginport="), loginPort);
+	FParse::Value(commandLine, TEXT("multiplayerport="), multiplayerPort);
 }
 
-bool URealmGameInstance::ConnectLoginSocket()
+bool URealmGameInstance::SendFrame(FSocket* socket, const TArray<uint8>& frame)
 {
-	//try to establish a connection to the login server
-	if (!loginSocketThread || !loginSocket || loginSocket->GetConnectionState() != SCS_Connected)
-	{
-		FSocket* ls = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateSocket(NAME_Stream, TEXT("login"), false);
-		auto resolveInfo = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName("mythosrealm.ddns.net");
-
-		while (!resolveInfo->IsComplete());
+	if (!socket)
+		return false;
 
-		uint32 outip = 0;
-		if (resolveInfo->GetErrorCode() == 0)
-		{
-			const FInternetAddr* addr = &resolveInfo->GetResolvedAddress();
-			addr->GetIp(outip);
-		}
-		else
+	//keep sending until the whole frame is out, a partial frame would break every message after it
+	int32 totalSent = 0;
+	while (totalSent < frame.Num())
+	{
+		int32 sent = 0;
+		if (!socket->Send(frame.GetData() + totalSent, frame.Num() - totalSent, sent) || sent <= 0)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to resolve the hostname"));
+			UE_LOG(LogTemp, Warning, TEXT("failed to send"));
 			return false;
 		}
 
-		int32 port = 3308;
-		TSharedRef<FInternetAddr> addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
-		addr->SetIp(outip);
-		addr->SetPort(port);
+		totalSent += sent;
+	}
 
-		int32 ReceiveBufferSize = 2 * 1024 * 1024;
-		int32 newSize = 0;
-		ls->SetReceiveBufferSize(ReceiveBufferSize, newSize);
-		ls->SetSendBufferSize(ReceiveBufferSize, newSize);
+	UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), totalSent);
+	return true;
+}
 
-		bool connected = ls->Connect(*addr);
-		if (!connected)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to connect to the login server"));
-			return false;
-		}
+bool URealmGameInstance::SendLoginFrame(const TArray<uint8>& frame)
+{
+	if (loginSocketThread && loginSocket && loginSocket->GetConnectionState() == SCS_Connected)
+		return SendFrame(loginSocket, frame);
 
-		loginSocketThread = FRealmSocketListener::CreateListener(ls, true);
-		loginSocketThread->gameInstance = this;
-		loginSocket = ls;
+	pendingLoginFrames.Add(frame);
+	if (!ConnectLoginSocket())
+	{
+		pendingLoginFrames.Empty();
+		return false;
+	}
 
-		if (GetWorld())
-			GetWorld()->GetTimerManager().SetTimer(loginSocketListenTimer, this, &URealmGameInstance::ListenLoginSocket, 0.03f, true);
+	return true;
+}
 
-		UE_LOG(LogTemp, Warning, TEXT("connected to the login server"));
+bool URealmGameInstance::SendMultiplayerFrame(const TArray<uint8>& frame)
+{
+	if (multiplayerSocketThread && multiplayerSocket && multiplayerSocket->GetConnectionState() == SCS_Connected)
+		return SendFrame(multiplayerSocket, frame);
 
-		return true;
+	pendingMultiplayerFrames.Add(frame);
+	if (!ConnectMultiplayerSocket())
+	{
+		pendingMultiplayerFrames.Empty();
+		return false;
 	}
 
 	return true;
 }
 
-bool URealmGameInstance::ConnectMultiplayerSocket()
+bool URealmGameInstance::ConnectLoginSocket()
 {
-	//try to establish a connection to the multiplayer master server
-	if (!multiplayerSocketThread || !multiplayerSocket || multiplayerSocket->GetConnectionState() != SCS_Connected)
+	if (loginSocketThread && loginSocket && loginSocket->GetConnectionState() == SCS_Connected)
+		return true;
+
+	//already connecting, whatever is held gets sent once it does
+	if (connectingLoginSocket)
+		return true;
+
+	bLoginConnectPending = true;
+	if (!ResolveBackendHost())
 	{
-		FSocket* ms = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateSocket(NAME_Stream, TEXT("multiplayer"), false);
-		auto resolveInfo = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName("mythosrealm.ddns.net");
+		bLoginConnectPending = false;
+		return false;
+	}
 
-		while (!resolveInfo->IsComplete());
+	return true;
+}
 
-		uint32 outip = 0;
-		if (resolveInfo->GetErrorCode() == 0)
-		{
-			const FInternetAddr* addr = &resolveInfo->GetResolvedAddress();
-			addr->GetIp(outip);
-		}
-		else
-		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to resolve the hostname"));
-			return false;
-		}
+bool URealmGameInstance::ConnectMultiplayerSocket()
+{
+	if (multiplayerSocketThread && multiplayerSocket && multiplayerSocket->GetConnectionState() == SCS_Connected)
+		return true;
 
-		int32 port = 3310;
+	if (connectingMultiplayerSocket)
+		return true;
 
-		TSharedRef<FInternetAddr> addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
-		addr->SetIp(outip);
-		addr->SetPort(port);
+	bMultiplayerConnectPending = true;
+	if (!ResolveBackendHost())
+	{
+		bMultiplayerConnectPending = false;
+		return false;
+	}
 
-		int32 ReceiveBufferSize = 2 * 1024 * 1024;
-		int32 newSize = 0;
-		ms->SetReceiveBufferSize(ReceiveBufferSize, newSize);
-		ms->SetSendBufferSize(ReceiveBufferSize, newSize);
+	return true;
+}
 
-		bool connected = ms->Connect(*addr);
-		if (!connected)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to connect to the multiplayer server"));
-			return false;
-		}
+bool URealmGameInstance::ResolveBackendHost()
+{
+	if (!GetWorld())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("no world to poll the backend connection with"));
+		return false;
+	}
 
-		multiplayerSocketThread = FRealmSocketListener::CreateListener(ms, false);
-		multiplayerSocketThread->gameInstance = this;
-		multiplayerSocket = ms;
+	//reuse the last address until it goes stale
+	if (cachedBackendIp != 0 && FPlatformTime::Seconds() - cachedBackendIpTime < backendAddressTTL)
+	{
+		OnBackendHostResolved(cachedBackendIp);
+		return true;
+	}
 
-		if (GetWorld())
-			GetWorld()->GetTimerManager().SetTimer(multiplayerSocketListenTimer, this, &URealmGameInstance::ListenMultiplayerSocket, 0.03f, true);
+	//a lookup is already running, it connects everything pending when it finishes
+	if (pendingResolve)
+		return true;
 
-		UE_LOG(LogTemp, Warning, TEXT("connected to the multiplayer server"));
+	//an ip needs no lookup
+	FIPv4Address ip;
+	if (FIPv4Address::Parse(backendHost, ip))
+	{
+		cachedBackendIp = ip.GetValue();
+		cachedBackendIpTime = FPlatformTime::Seconds();
+		OnBackendHostResolved(cachedBackendIp);
 		return true;
 	}
 
+	pendingResolve = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName(TCHAR_TO_ANSI(*backendHost));
+	if (!pendingResolve)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("failed to start resolving %s"), *backendHost);
+		return false;
+	}
+
+	StartBackendPoll();
 	return true;
 }
 
-void URealmGameInstance::ListenLoginSocket()
+void URealmGameInstance::StartBackendPoll()
 {
-	TArray<uint8> data;
+	if (GetWorld() && !GetWorld()->GetTimerManager().IsTimerActive(backendPollTimer))
+		GetWorld()->GetTimerManager().SetTimer(backendPollTimer, this, &URealmGameInstance::PollBackend, 0.02f, true);
+}
 
-	if (loginSocketThread)
+void URealmGameInstance::PollBackend()
+{
+	if (pendingResolve && pendingResolve->IsComplete())
+		FinishBackendResolve();
+
+	if (connectingLoginSocket)
+		PollLoginConnect();
+
+	if (connectingMultiplayerSocket)
+		PollMultiplayerConnect();
+
+	if (!pendingResolve && !connectingLoginSocket && !connectingMultiplayerSocket && GetWorld())
+		GetWorld()->GetTimerManager().ClearTimer(backendPollTimer);
+}
+
+void URealmGameInstance::FinishBackendResolve()
+{
+	uint32 outip = 0;
+	if (pendingResolve->GetErrorCode() == 0)
+		pendingResolve->GetResolvedAddress().GetIp(outip);
+
+	delete pendingResolve;
+	pendingResolve = nullptr;
+
+	if (outip == 0)
 	{
-		loginSocketThread->GetNextDataArray(data);
-		if (data.Num() > 0)
-			ParseLoginSocketData(data);
+		UE_LOG(LogTemp, Warning, TEXT("failed to resolve %s"), *backendHost);
+
+		bLoginConnectPending = false;
+		bMultiplayerConnectPending = false;
+		pendingLoginFrames.Empty();
+		pendingMultiplayerFrames.Empty();
+		return;
+	}
+
+	cachedBackendIp = outip;
+	cachedBackendIpTime = FPlatformTime::Seconds();
+	OnBackendHostResolved(outip);
+}
+
+void URealmGameInstance::OnBackendHostResolved(uint32 ip)
+{
+	if (bLoginConnectPending)
+	{
+		bLoginConnectPending = false;
+		OpenLoginSocket(ip);
+	}
+
+	if (bMultiplayerConnectPending)
+	{
+		bMultiplayerConnectPending = false;
+		OpenMultiplayerSocket(ip);
+	}
+}
+
+FSocket* URealmGameInstance::OpenBackendSocket(const FString& socketName, uint32 ip, int32 port)
+{
+	FSocket* socket = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateSocket(NAME_Stream, socketName, false);
+	if (!socket)
+		return nullptr;
+
+	TSharedRef<FInternetAddr> addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+	addr->SetIp(ip);
+	addr->SetPort(port);
+
+	int32 ReceiveBufferSize = 2 * 1024 * 1024;
+	int32 newSize = 0;
+	socket->SetReceiveBufferSize(ReceiveBufferSize, newSize);
+	socket->SetSendBufferSize(ReceiveBufferSize, newSize);
+
+	//connect in the background, PollBackend picks the socket up once it is connected
+	socket->SetNonBlocking(true);
+	if (!socket->Connect(*addr))
+	{
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(socket);
+
+		//the host may have moved, look it up again next time
+		cachedBackendIp = 0;
+		return nullptr;
+	}
+
+	return socket;
+}
+
+ESocketConnectionState URealmGameInstance::GetConnectState(FSocket* socket, double startTime) const
+{
+	const ESocketConnectionState state = socket->GetConnectionState();
+	if (state == SCS_NotConnected && FPlatformTime::Seconds() - startTime >= backendConnectTimeout)
+		return SCS_ConnectionError;
+
+	return state;
+}
+
+void URealmGameInstance::OpenLoginSocket(uint32 ip)
+{
+	connectingLoginSocket = OpenBackendSocket(TEXT("login"), ip, loginPort);
+	if (!connectingLoginSocket)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("failed to connect to the login server"));
+		pendingLoginFrames.Empty();
+		return;
+	}
+
+	loginConnectStartTime = FPlatformTime::Seconds();
+	StartBackendPoll();
+}
+
+void URealmGameInstance::OpenMultiplayerSocket(uint32 ip)
+{
+	connectingMultiplayerSocket = OpenBackendSocket(TEXT("multiplayer"), ip, multiplayerPort);
+	if (!connectingMultiplayerSocket)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("failed to connect to the multiplayer server"));
+		pendingMultiplayerFrames.Empty();
+		return;
+	}
+
+	multiplayerConnectStartTime = FPlatformTime::Seconds();
+	StartBackendPoll();
+}
+
+void URealmGameInstance::PollLoginConnect()
+{
+	const ESocketConnectionState state = GetConnectState(connectingLoginSocket, loginConnectStartTime);
+	if (state == SCS_NotConnected)
+		return;
+
+	FSocket* ls = connectingLoginSocket;
+	connectingLoginSocket = nullptr;
+
+	if (state != SCS_Connected)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("failed to connect to the login server"));
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ls);
+		cachedBackendIp = 0;
+		pendingLoginFrames.Empty();
+		return;
+	}
+
+	//SendFrame and the listener expect a blocking socket
+	ls->SetNonBlocking(false);
+
+	loginSocketThread = FRealmSocketListener::CreateListener(ls, true);
+	loginSocketThread->gameInstance = this;
+	loginSocket = ls;
+
+	if (GetWorld())
+		GetWorld()->GetTimerManager().SetTimer(loginSocketListenTimer, this, &URealmGameInstance::ListenLoginSocket, 0.03f, true);
+
+	UE_LOG(LogTemp, Warning, TEXT("connected to the login server"));
+
+	for (const TArray<uint8>& frame : pendingLoginFrames)
+		SendFrame(loginSocket, frame);
+	pendingLoginFrames.Empty();
+}
+
+void URealmGameInstance::PollMultiplayerConnect()
+{
+	const ESocketConnectionState state = GetConnectState(connectingMultiplayerSocket, multiplayerConnectStartTime);
+	if (state == SCS_NotConnected)
+		return;
+
+	FSocket* ms = connectingMultiplayerSocket;
+	connectingMultiplayerSocket = nullptr;
+
+	if (state != SCS_Connected)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("failed to connect to the multiplayer server"));
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ms);
+		cachedBackendIp = 0;
+		pendingMultiplayerFrames.Empty();
+		return;
 	}
+
+	ms->SetNonBlocking(false);
+
+	multiplayerSocketThread = FRealmSocketListener::CreateListener(ms, false);
+	multiplayerSocketThread->gameInstance = this;
+	multiplayerSocket = ms;
+
+	if (GetWorld())
+		GetWorld()->GetTimerManager().SetTimer(multiplayerSocketListenTimer, this, &URealmGameInstance::ListenMultiplayerSocket, 0.03f, true);
+
+	UE_LOG(LogTemp, Warning, TEXT("connected to the multiplayer server"));
+
+	for (const TArray<uint8>& frame : pendingMultiplayerFrames)
+		SendFrame(multiplayerSocket, frame);
+	pendingMultiplayerFrames.Empty();
+}
+
+void URealmGameInstance::ListenLoginSocket()
+{
+	DrainSocket(loginSocketThread, true);
 }
 
 void URealmGameInstance::ListenMultiplayerSocket()
 {
-	TArray<uint8> data;
+	DrainSocket(multiplayerSocketThread, false);
+}
 
-	if (multiplayerSocketThread)
+int32 URealmGameInstance::DrainSocket(FRealmSocketListener* listener, bool bLoginSocket)
+{
+	if (!listener)
+		return 0;
+
+	const double startTime = FPlatformTime::Seconds();
+	const double budgetSeconds = socketPollBudget / 1000.0;
+
+	int32 handled = 0;
+	bool bOverBudget = false;
+	TArray<uint8> data;
+	double enqueueTime;
+	while (listener->DequeueFrame(data, enqueueTime))
 	{
-		multiplayerSocketThread->GetNextDataArray(data);
-		if (data.Num() > 0)
+		const double latency = FPlatformTime::Seconds() - enqueueTime;
+		messageLatencyTotal += latency;
+		messageLatencyPeak = FMath::Max(messageLatencyPeak, latency);
+		messagesHandled++;
+		handled++;
+
+		if (bLoginSocket)
+			ParseLoginSocketData(data);
+		else
 			ParseMultiplayerSocketData(data);
+
+		//leave the rest for the next poll rather than stall the frame
+		if (FPlatformTime::Seconds() - startTime >= budgetSeconds)
+		{
+			pollsOverBudget++;
+			bOverBudget = true;
+			break;
+		}
+	}
+
+	//check the flag before the queue, the listener queues its last frames before it closes
+	if (!bOverBudget && listener->IsConnectionClosed() && !listener->HasQueuedFrames())
+	{
+		if (bLoginSocket)
+			CloseBackendSocket(loginSocketThread, loginSocket, loginSocketListenTimer);
+		else
+			CloseBackendSocket(multiplayerSocketThread, multiplayerSocket, multiplayerSocketListenTimer);
+	}
+
+	ReportMessageLatency();
+	return handled;
+}
+
+void URealmGameInstance::CloseBackendSocket(FRealmSocketListener*& listener, FSocket*& socket, FTimerHandle& listenTimer)
+{
+	if (GetWorld())
+		GetWorld()->GetTimerManager().ClearTimer(listenTimer);
+
+	if (listener)
+	{
+		listener->EnsureCompletion();
+		delete listener;
+		listener = nullptr;
+	}
+
+	if (socket)
+	{
+		socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(socket);
+		socket = nullptr;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("dropped a backend connection, it will reconnect on the next send"));
+}
+
+void URealmGameInstance::ReportMessageLatency()
+{
+	const double now = FPlatformTime::Seconds();
+	if (latencyReportStartTime == 0.0)
+		latencyReportStartTime = now;
+
+	if (now - latencyReportStartTime < 60.0)
+		return;
+
+	if (messagesHandled > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("backend messages: %d handled, %.2f ms avg latency, %.2f ms peak, %d polls over the %.2f ms budget"), messagesHandled,
+			messageLatencyTotal / messagesHandled * 1000.0, messageLatencyPeak * 1000.0, pollsOverBudget, socketPollBudget);
 	}
+
+	messageLatencyTotal = 0.0;
+	messageLatencyPeak = 0.0;
+	messagesHandled = 0;
+	pollsOverBudget = 0;
+	latencyReportStartTime = now;
 }
 
 void URealmGameInstance::ParseLoginSocketData(const TArray<uint8>& ReceivedData)
@@ -165,61 +496,61 @@ void URealmGameInstance::ParseLoginSocketData(const TArray<uint8>& ReceivedData)
 		return;
 	}
 
-	//VShow("Total Data read!", ReceivedData.Num());
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Data Bytes Read ~> %d"), ReceivedData.Num()));
-
-
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-	const FString ReceivedUE4String = StringFromBinaryArray(ReceivedData);
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-
 	ARealmMainMenu* mm = Cast<ARealmMainMenu>(GetWorld()->GetAuthGameMode());
 	if (!IsValid(mm))
 		return;
 
-	TArray<FString> data;
-	ReceivedUE4String.ParseIntoArray(data, TEXT("|"), false);
-
-	if (data.Num() > 0)
+	FRealmBackendReader reader(ReceivedData.GetData(), ReceivedData.Num());
+	switch (reader.GetType())
 	{
-		//login parsing
-		if (data[0].Equals("loginSuccess"))
-		{
-			currentUserid = data[2];
-			currentAlias = data[8];
-			currentMythosPoints = FCString::Atoi(*data[6]);
+	case ERealmBackendMessage::LoginSuccess:
+	{
+		FRealmLoginSuccessMessage message;
+		if (!FRealmBackendProtocol::DecodeLoginSuccess(reader, message))
+			break;
 
-			mm->PlayerLoginSuccessful(currentUserid, FCString::Atoi(*data[4]), currentMythosPoints, currentAlias);
-			UE_LOG(LogTemp, Warning, TEXT("Logged in successfully as %s!"), *data[8]);
-		}
-		if (data[0].Equals("loginFailure"))
-		{
-			mm->PlayerLoginNotSuccessful();
-			UE_LOG(LogTemp, Warning, TEXT("Failed to login!"));
-		}
-		if (data[0].Equals("createLoginSuccess"))
-		{
-			mm->CreatePlayerLoginSuccessful();
-			UE_LOG(LogTemp, Warning, TEXT("Created new account successfully!"));
-		}
-		if (data[0].Equals("createLoginFailure"))
-		{
-			mm->CreatePlayerLoginUnsuccessful(data[1]);
-			UE_LOG(LogTemp, Warning, TEXT("Couldn't create new account. Reason: %s"), *data[1]);
-		}
-		if (data[0].Equals("updateInfo"))
-		{
-			ReceiveInfoUpdate(data[1], FCString::Atoi(*data[2]));
-			UE_LOG(LogTemp, Warning, TEXT("Received info update"));
-		}
+		currentUserid = message.userid.ToString();
+		currentAlias = message.alias.ToString();
+		currentMythosPoints = message.mythosPoints;
+
+		mm->PlayerLoginSuccessful(currentUserid, message.experience, currentMythosPoints, currentAlias);
+		UE_LOG(LogTemp, Warning, TEXT("Logged in successfully as %s!"), *currentAlias);
+		return;
+	}
+	case ERealmBackendMessage::LoginFailure:
+		mm->PlayerLoginNotSuccessful();
+		UE_LOG(LogTemp, Warning, TEXT("Failed to login!"));
+		return;
+	case ERealmBackendMessage::CreateLoginSuccess:
+		mm->CreatePlayerLoginSuccessful();
+		UE_LOG(LogTemp, Warning, TEXT("Created new account successfully!"));
+		return;
+	case ERealmBackendMessage::CreateLoginFailure:
+	{
+		FRealmCreateLoginFailureMessage message;
+		if (!FRealmBackendProtocol::DecodeCreateLoginFailure(reader, message))
+			break;
 
-		//multiplayer lobby parsing
+		const FString reason = message.reason.ToString();
+		mm->CreatePlayerLoginUnsuccessful(reason);
+		UE_LOG(LogTemp, Warning, TEXT("Couldn't create new account. Reason: %s"), *reason);
+		return;
+	}
+	case ERealmBackendMessage::UpdateInfo:
+	{
+		FRealmUpdateInfoMessage message;
+		if (!FRealmBackendProtocol::DecodeUpdateInfo(reader, message))
+			break;
 
-		//connectionSocket->Close();
+		ReceiveInfoUpdate(message.alias.ToString(), message.mythosPoints);
+		UE_LOG(LogTemp, Warning, TEXT("Received info update"));
+		return;
+	}
+	default:
+		break;
 	}
 
-	//VShow("As String!!!!! ~>", ReceivedUE4String);
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("As String Data ~> %s"), *ReceivedUE4String));
+	UE_LOG(LogTemp, Warning, TEXT("received an unknown or malformed message from the login server"));
 }
 
 void URealmGameInstance::ParseMultiplayerSocketData(const TArray<uint8>& ReceivedData)
@@ -234,52 +565,51 @@ void URealmGameInstance::ParseMultiplayerSocketData(const TArray<uint8>& Receive
 	if (!IsValid(mm))
 		return;
 
-	const FString ReceivedUE4String = StringFromBinaryArray(ReceivedData);
-	TArray<FString> data;
-	ReceivedUE4String.ParseIntoArray(data, TEXT("|"), false);
+	FRealmBackendReader reader(ReceivedData.GetData(), ReceivedData.Num());
+	switch (reader.GetType())
+	{
+	case ERealmBackendMessage::JoinedQueueSuccessfully:
+		mm->JoinMMQueueSuccessful();
+		UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue successfully "));
+		return;
+	case ERealmBackendMessage::JoinedQueueFailed:
+		mm->JoinMMQueueFailed();
+		UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue failed "));
+		return;
+	case ERealmBackendMessage::FoundMatch:
+	{
+		FRealmFoundMatchMessage message;
+		if (!FRealmBackendProtocol::DecodeFoundMatch(reader, message))
+			break;
 
-	if (data.Num() > 0)
+		mm->FoundMatch(message.matchID.ToString());
+		UE_LOG(LogTemp, Warning, TEXT("MM found a match "));
+		return;
+	}
+	case ERealmBackendMessage::FoundMatchConfirmed:
 	{
-		if (data[0].Equals("joinedQueueSuccessfully"))
-		{
-			mm->JoinMMQueueSuccessful();
-			UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue successfully "));
-		}
-		if (data[0].Equals("joinedQueueFailed"))
-		{
-			mm->JoinMMQueueFailed();
-			UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue failed "));
-		}
-		if (data[0].Equals("foundMatch"))
-		{
-			mm->FoundMatch(data[1]);
-			UE_LOG(LogTemp, Warning, TEXT("MM found a match "));
-		}
-		if (data[0].Equals("foundMatchConfirmed"))
-		{
-			mm->FoundConfirmedMatch(data[1]);
-			UE_LOG(LogTemp, Warning, TEXT("MM found a confirmed match"));
-		}
-		if (data[0].Equals("matchConfirmFailed"))
-		{
-			mm->FailedToConfirmMatch();
-			UE_LOG(LogTemp, Warning, TEXT("MM failed to confirm a match "));
-		}
+		FRealmFoundMatchConfirmedMessage message;
+		if (!FRealmBackendProtocol::DecodeFoundMatchConfirmed(reader, message))
+			break;
+
+		mm->FoundConfirmedMatch(message.matchAddress.ToString());
+		UE_LOG(LogTemp, Warning, TEXT("MM found a confirmed match"));
+		return;
+	}
+	case ERealmBackendMessage::MatchConfirmFailed:
+		mm->FailedToConfirmMatch();
+		UE_LOG(LogTemp, Warning, TEXT("MM failed to confirm a match "));
+		return;
+	default:
+		break;
 	}
+
+	UE_LOG(LogTemp, Warning, TEXT("received an unknown or malformed message from the multiplayer server"));
 }
 
 bool URealmGameInstance::AttemptLogin(FString username, FString password)
 {
-	if (!ConnectLoginSocket())
-		return false;
-
-	//encode username
-	FString serialized = "login|username|";
-	serialized = serialized + username;
-
 	//encode encrypted password
-	FString serialized1 = "|password|";
-
 	std::string stdstring(TCHAR_TO_UTF8(*password));
 	FSHA1 hashState;
 	hashState.Update((uint8*)stdstring.c_str(), stdstring.size());
@@ -288,38 +618,15 @@ bool URealmGameInstance::AttemptLogin(FString username, FString password)
 	uint8 passwordHash[FSHA1::DigestSize];
 	hashState.GetHash(passwordHash);
 	FString pwdStr = BytesToHex(passwordHash, FSHA1::DigestSize);
-	serialized1 = serialized1 + pwdStr;
-
-	//get the full login string
-	FString prStr = serialized + serialized1;
 
 	//send the encrypted data to the login server
-	TCHAR *serializedChar = prStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
-
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = loginSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return false;
-	}
-
-	return true;
+	TArray<uint8> frame;
+	FRealmBackendProtocol::EncodeLogin(frame, username, pwdStr);
+	return SendLoginFrame(frame);
 }
 
 bool URealmGameInstance::AttemptCreateLogin(FString username, FString password, FString email, FString ingameAlias)
 {
-	if (!ConnectLoginSocket())
-		return false;
-
-	FString sendStr = "loginCreate|username|";
-	sendStr += username;
-	sendStr += "|password|";
-
 	std::string stdstring(TCHAR_TO_UTF8(*password));
 	FSHA1 hashState;
 	hashState.Update((uint8*)stdstring.c_str(), stdstring.size());
@@ -329,26 +636,10 @@ bool URealmGameInstance::AttemptCreateLogin(FString username, FString password,
 	hashState.GetHash(passwordHash);
 	FString pwdStr = BytesToHex(passwordHash, FSHA1::DigestSize);
 
-	sendStr += pwdStr;
-	sendStr += "|email|" + email;
-	sendStr += "|ingame|" + ingameAlias;
-
 	//send the encrypted data to the login server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
-
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = loginSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return false;
-	}
-
-	return true;
+	TArray<uint8> frame;
+	FRealmBackendProtocol::EncodeLoginCreate(frame, username, pwdStr, email, ingameAlias);
+	return SendLoginFrame(frame);
 }
 
 void URealmGameInstance::SendMatchComplete(ARealmGameMode* gameMode)
@@ -358,28 +649,11 @@ void URealmGameInstance::SendMatchComplete(ARealmGameMode* gameMode)
 
 	if (gameMode->bRankedGame)
 	{
-		if (!ConnectMultiplayerSocket())
-			return;
-
-		FString sendStr = "rankedGameFinished|";
-		for (int32 i = 0; i < gameMode->endgameUserids.Num(); i++)
-			sendStr += gameMode->endgameUserids[i] + ",";
-		sendStr += "|";
-		for (int32 j = 0; j < gameMode->endgameTeams.Num(); j++)
-			sendStr += FString::FromInt(gameMode->endgameTeams[j]) + ",";
-		sendStr += "|" + FString::FromInt(gameMode->winningTeamIndex);
-
 		//send the data to the server
-		TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-		int32 encSize = FCString::Strlen(serializedChar);
-		int32 sent = 0;
-
-		//send and store whether or not it was successful
-		bool bSuccesfullySent = multiplayerSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-		if (bSuccesfullySent)
-			UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-		if (!bSuccesfullySent)
-			UE_LOG(LogTemp, Warning, TEXT("failed to send"));
+		TArray<uint8> frame;
+		FRealmBackendProtocol::EncodeRankedGameFinished(frame, gameMode->endgameUserids, gameMode->endgameTeams, gameMode->winningTeamIndex);
+		if (!SendMultiplayerFrame(frame))
+			return;
 
 		FTimerHandle exitTimer;
 		gameMode->GetWorldTimerManager().SetTimer(exitTimer, this, &URealmGameInstance::CloseGameInstance, 35.f, false);
@@ -393,95 +667,32 @@ void URealmGameInstance::CloseGameInstance()
 
 FString URealmGameInstance::GetRealmServerIP(int32 port)
 {
-	auto resolveInfo = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName("mythosrealm.ddns.net");
-
-	while (!resolveInfo->IsComplete());
-
-	uint32 outip = 0;
-	if (resolveInfo->GetErrorCode() == 0)
-	{
-		const FInternetAddr* addr = &resolveInfo->GetResolvedAddress();
-		addr->GetIp(outip);
-	}
+	FString host = GetDefault<URealmGameInstance>()->backendHost;
+	FParse::Value(FCommandLine::Get(), TEXT("backendhost="), host);
 
-	FIPv4Address ip = FIPv4Address(outip);
-	FString ipstr = ip.ToText().ToString();
-	ipstr += ":" + port;
-
-	return ipstr;
+	//hand back the host name, the net driver resolves it without holding up the game thread
+	return FString::Printf(TEXT("%s:%d"), *host, port);
 }
 
 bool URealmGameInstance::AttemptJoinSoloMMQueue(const FString& queue)
 {
-	if (!ConnectMultiplayerSocket())
-		return false;
-
-	FString sendStr = "playerWantsMMQueue|" + GetUserID() + "|" + queue;
-
-	//send the data to the server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
-
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = multiplayerSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return false;
-	}
-
-	return true;
+	TArray<uint8> frame;
+	FRealmBackendProtocol::EncodePlayerWantsMMQueue(frame, GetUserID(), queue);
+	return SendMultiplayerFrame(frame);
 }
 
 bool URealmGameInstance::SendConfirmMatch(const FString& matchID)
 {
-	if (!ConnectMultiplayerSocket())
-		return false;
-
-	FString sendStr = "playerConfirmMatch|" + GetUserID() + "|" + matchID;
-
-	//send the data to the server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
-
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = multiplayerSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return false;
-	}
-
-	return true;
+	TArray<uint8> frame;
+	FRealmBackendProtocol::EncodePlayerConfirmMatch(frame, GetUserID(), matchID);
+	return SendMultiplayerFrame(frame);
 }
 
 void URealmGameInstance::QueryLoginServerForUpdate()
 {
-	if (!ConnectLoginSocket())
-		return;
-
-	FString sendStr = "getInfoUpdate|" + GetUserID();
-
-	//send the data to the server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
-
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = loginSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return;
-	}
+	TArray<uint8> frame;
+	FRealmBackendProtocol::EncodeGetInfoUpdate(frame, GetUserID());
+	SendLoginFrame(frame);
 }
 
 void URealmGameInstance::ReceiveInfoUpdate(const FString& alias, int32 mp)
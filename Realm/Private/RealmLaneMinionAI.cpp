@@ -5,11 +5,14 @@
 #include "RealmObjective.h"
 #include "PlayerCharacter.h"
 #include "RealmTurret.h"
+#include "RealmGameMode.h"
 
 ARealmLaneMinionAI::ARealmLaneMinionAI(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
 	aggroDistance = 420.f;
+	nextTargetingTime = 0.f;
+	updateInterval = 1.f / 30.f;
 }
 
 void ARealmLaneMinionAI::Possess(APawn* InPawn)
@@ -22,6 +25,15 @@ void ARealmLaneMinionAI::Possess(APawn* InPawn)
 
 	mc->GetStatsManager()->SetMaxHealth();
 
+	minionCharacter = mc;
+	StartLane();
+}
+
+void ARealmLaneMinionAI::StartLane()
+{
+	ARealmObjective* oldObjective;
+	while (objectives.Dequeue(oldObjective));
+
 	objectives.Enqueue(laneManager->laneObjectives[0]);
 	for (int32 i = 0; i < laneManager->enemyLane->laneObjectives.Num(); i++)
 		objectives.Enqueue(laneManager->enemyLane->laneObjectives[i]);
@@ -30,35 +42,44 @@ void ARealmLaneMinionAI::Possess(APawn* InPawn)
 	MoveToActor(objectiveTarget);
 	currentTargetPriority = ELaneMinionTargetPriority::LMTP_ObjectiveTarget;
 
-	minionCharacter = mc;
-
-	FTimerHandle t;
-	GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 1.f / 30.f, true);
-	GetWorldTimerManager().SetTimer(t, this, &ARealmLaneMinionAI::CheckReachedObjective, 1.f / 30.f, true);
+	//targets are picked by the game mode's batched targeting pass instead of a timer on every minion
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+		gm->GetMinionTargeting().AddMinion(this);
 }
 
-void ARealmLaneMinionAI::OnTargetEnterRadius(class APawn* pawn)
+void ARealmLaneMinionAI::Park()
 {
-	/*AGameCharacter* gc = Cast<AGameCharacter>(pawn);
-	AMinionCharacter* mc = Cast<AMinionCharacter>(GetCharacter());
+	StopMovement();
+	GetWorldTimerManager().ClearAllTimersForObject(this);
 
-	if (!IsValid(gc))
-		return;
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+	{
+		gm->GetMinionTargeting().RemoveMinion(this);
+		gm->GetAIScheduler().RemoveController(this);
+	}
+}
 
-	if (gc->GetTeamIndex() == mc->GetTeamIndex() || !gc->IsAlive())
-		return;
+void ARealmLaneMinionAI::ResetForReuse()
+{
+	nextTarget = nullptr;
+	repositionTarget = nullptr;
+	nextTargetPriority = ELaneMinionTargetPriority::LMTP_ObjectiveTarget;
+	bRepositioned = false;
+	nextTargetingTime = 0.f;
 
-	if (currentTargetPriority == ELaneMinionTargetPriority::LMTP_ObjectiveTarget)
-	{
-		ELaneMinionTargetPriority priority;
+	StartLane();
 
-		gc->IsA(APlayerCharacter::StaticClass()) ? priority = ELaneMinionTargetPriority::LMTP_ClosestMythos : priority = ELaneMinionTargetPriority::LMTP_ClosestMinion;
-		if (gc->IsA(ARealmObjective::StaticClass()))
-			priority = ELaneMinionTargetPriority::LMTP_ObjectiveTarget;
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+		gm->GetAIScheduler().AddController(this, GetWorld()->GetTimeSeconds());
+}
 
-		SetNewTarget(gc, priority);
-		mc->StartAutoAttack();
-	}*/
+void ARealmLaneMinionAI::ScheduledUpdate()
+{
+	if (IsValid(minionCharacter) && minionCharacter->IsAlive())
+		CheckReachedObjective();
 }
 
 void ARealmLaneMinionAI::CheckReachedObjective()
@@ -82,7 +103,7 @@ void ARealmLaneMinionAI::CheckReachedObjective()
 	}
 }
 
-void ARealmLaneMinionAI::ReevaluateTargets()
+void ARealmLaneMinionAI::ReevaluateTargets(const TArray<AGameCharacter*>& candidates)
 {
 	if (!IsValid(minionCharacter))
 		return;
@@ -91,14 +112,14 @@ void ARealmLaneMinionAI::ReevaluateTargets()
 	{
 		float distsq = (minionCharacter->GetActorLocation() - minionCharacter->GetCurrentTarget()->GetActorLocation()).SizeSquared2D();
 		if (!minionCharacter->GetCurrentTarget()->IsAlive() || !minionCharacter->CanSeeOtherCharacter(minionCharacter->GetCurrentTarget()) || !minionCharacter->GetCurrentTarget()->IsTargetable() || distsq > FMath::Square(aggroDistance / 2.f))
-			NeedsNewCommand();
+			AcquireTarget(candidates);
 		else if (distsq > FMath::Square(minionCharacter->GetCurrentValueForStat(EStat::ES_AARange)))
 			MoveToActor(minionCharacter->GetCurrentTarget(), minionCharacter->GetCurrentValueForStat(EStat::ES_AARange));
 		else
 			minionCharacter->StartAutoAttack();
 	}
 	else
-		NeedsNewCommand();
+		AcquireTarget(candidates);
 }
 
 void ARealmLaneMinionAI::SetNewTarget(AGameCharacter* newTarget, ELaneMinionTargetPriority targetPriority)
@@ -117,6 +138,26 @@ void ARealmLaneMinionAI::SetLaneManager(ALaneManager* newLaneManager)
 }
 
 void ARealmLaneMinionAI::NeedsNewCommand()
+{
+	//dead and parked minions can still hear calls for help
+	if (!IsValid(minionCharacter) || !minionCharacter->IsAlive())
+		return;
+
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
+		return;
+
+	//asked for a command outside of the batched pass, so gather our own candidates
+	FRealmCharacterFilter filter;
+	filter.excludedTeam = minionCharacter->GetTeamIndex();
+
+	TArray<AGameCharacter*> candidates;
+	gm->GetCharacterHash().QueryRadius(minionCharacter->GetActorLocation(), aggroDistance, filter, candidates);
+
+	AcquireTarget(candidates);
+}
+
+void ARealmLaneMinionAI::AcquireTarget(const TArray<AGameCharacter*>& candidates)
 {
 	if (!IsValid(minionCharacter))
 		return;
@@ -132,58 +173,53 @@ void ARealmLaneMinionAI::NeedsNewCommand()
 		return;
 	}
 
-	TArray<FHitResult> hits;
-	FVector start = minionCharacter->GetActorLocation();
-	FVector end = start;
-	end.Z += 5.f;
+	//aggro minions first, then objectives, then mythos, taking the closest of the best group
+	const FVector location = minionCharacter->GetActorLocation();
+	const float aggroDistanceSq = FMath::Square(aggroDistance);
 
-	TArray<AGameCharacter*> possibleTargets;
+	AGameCharacter* bestTarget = nullptr;
+	int32 bestRank = MAX_int32;
+	float bestDistanceSq = MAX_FLT;
 
-	GetWorld()->SweepMultiByChannel(hits, start, end, minionCharacter->GetActorRotation().Quaternion(), ECC_Visibility, FCollisionShape::MakeSphere(aggroDistance));
-	for (FHitResult hit : hits)
+	for (AGameCharacter* gc : candidates)
 	{
-		AGameCharacter* gc = Cast<AGameCharacter>(hit.GetActor());
-		if (IsValid(gc) && gc->IsAlive() && minionCharacter->GetTeamIndex() != gc->GetTeamIndex())
-			possibleTargets.AddUnique(gc);
-	}
+		if (!IsValid(gc) || !gc->IsAlive())
+			continue;
 
-	//first aggro any minions first
-	for (AGameCharacter* gc : possibleTargets)
-	{
+		int32 rank;
 		if (gc->IsA(AMinionCharacter::StaticClass()))
-		{
-			ELaneMinionTargetPriority priority = ELaneMinionTargetPriority::LMTP_ClosestMinion;
-			SetNewTarget(gc, priority);
-			minionCharacter->StartAutoAttack();
+			rank = 0;
+		else if (gc->IsA(ARealmObjective::StaticClass()))
+			rank = 1;
+		else if (gc->IsA(APlayerCharacter::StaticClass()))
+			rank = 2;
+		else
+			continue;
 
-			return;
-		}
-	}
+		if (rank > bestRank)
+			continue;
 
-	//then aggro an objective if we can 
-	for (AGameCharacter* gc : possibleTargets)
-	{
-		if (gc->IsA(ARealmObjective::StaticClass()))
-		{
-			ELaneMinionTargetPriority priority = ELaneMinionTargetPriority::LMTP_ObjectiveTarget;
-			SetNewTarget(gc, priority);
-			minionCharacter->StartAutoAttack();
+		const float distanceSq = (gc->GetActorLocation() - location).SizeSquared2D();
+		if (distanceSq > aggroDistanceSq || (rank == bestRank && distanceSq >= bestDistanceSq))
+			continue;
 
-			return;
-		}
+		if (!minionCharacter->HasLineOfSightTo(gc))
+			continue;
+
+		bestTarget = gc;
+		bestRank = rank;
+		bestDistanceSq = distanceSq;
 	}
 
-	//lastly aggro any mythos
-	for (AGameCharacter* gc : possibleTargets)
+	if (IsValid(bestTarget))
 	{
-		if (gc->IsA(APlayerCharacter::StaticClass()))
-		{
-			ELaneMinionTargetPriority priority = ELaneMinionTargetPriority::LMTP_ClosestMythos;
-			SetNewTarget(gc, priority);
-			minionCharacter->StartAutoAttack();
+		const ELaneMinionTargetPriority priority = bestRank == 0 ? ELaneMinionTargetPriority::LMTP_ClosestMinion :
+			(bestRank == 1 ? ELaneMinionTargetPriority::LMTP_ObjectiveTarget : ELaneMinionTargetPriority::LMTP_ClosestMythos);
 
-			return;
-		}
+		SetNewTarget(bestTarget, priority);
+		minionCharacter->StartAutoAttack();
+
+		return;
 	}
 
 	//no in-range targets, so travel to the next objective target
@@ -363,13 +399,19 @@ void ARealmLaneMinionAI::CharacterInAttackRange()
 	}*/
 
 	//see if there are any friendlies in range
-	for (TActorIterator<AMinionCharacter> minion(GetWorld()); minion; ++minion)
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
 	{
-		AMinionCharacter* mc = *minion;
-		FVector targetVector = mc->GetActorLocation() - minionCharacter->GetActorLocation();
-		float distance = targetVector.Size();
-		if (IsValid(mc) && mc->IsAlive() && mc != minionCharacter && mc->GetTeamIndex() == minionCharacter->GetTeamIndex() && distance <= 75.f)
+		FRealmCharacterFilter filter;
+		filter.team = minionCharacter->GetTeamIndex();
+		filter.characterClass = AMinionCharacter::StaticClass();
+		filter.ignoredCharacter = minionCharacter;
+
+		AGameCharacter* mc = gm->GetCharacterHash().FindNearest(minionCharacter->GetActorLocation(), 75.f, filter);
+		if (IsValid(mc))
 		{
+			FVector targetVector = mc->GetActorLocation() - minionCharacter->GetActorLocation();
+
 			FTimerHandle handle;
 			GetWorldTimerManager().SetTimer(handle, this, &ARealmLaneMinionAI::CharacterInAttackRange, 0.15f);
 			bRepositioned = true;
@@ -380,7 +422,8 @@ void ARealmLaneMinionAI::CharacterInAttackRange()
 			minionCharacter->StopAutoAttack();
 			MoveToLocation(minionCharacter->GetActorLocation() + (newLoc.Rotation().Vector() * 25.f));
 
-			GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 0.8f, true);
+			//give the minion time to reposition before the targeting pass looks at it again
+			nextTargetingTime = GetWorld()->GetTimeSeconds() + 0.8f;
 
 			return;
 		}
@@ -394,6 +437,15 @@ void ARealmLaneMinionAI::CharacterInAttackRange()
 	}
 }
 
+void ARealmLaneMinionAI::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+		gm->GetMinionTargeting().RemoveMinion(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ARealmLaneMinionAI::Destroy(bool bNetForce, bool bShouldModifyLevel)
 {
 	GetWorldTimerManager().ClearAllTimersForObject(this);
@@ -0,0 +1,91 @@
+#include "Realm.h"
+#include "RealmMinionTargeting.h"
+#include "RealmCharacterHash.h"
+#include "RealmLaneMinionAI.h"
+#include "MinionCharacter.h"
+
+FRealmMinionTargeting::FRealmMinionTargeting()
+: targetingInterval(1.f / 30.f), timeSinceLastPass(0.f)
+{
+
+}
+
+void FRealmMinionTargeting::SetTargetingInterval(float newInterval)
+{
+	targetingInterval = FMath::Max(newInterval, 0.f);
+}
+
+void FRealmMinionTargeting::AddMinion(ARealmLaneMinionAI* minionAI)
+{
+	if (IsValid(minionAI))
+		minions.AddUnique(minionAI);
+}
+
+void FRealmMinionTargeting::RemoveMinion(ARealmLaneMinionAI* minionAI)
+{
+	minions.RemoveSingleSwap(minionAI);
+}
+
+void FRealmMinionTargeting::Update(float deltaSeconds, float worldTime, const FRealmCharacterHash& characterHash)
+{
+	timeSinceLastPass += deltaSeconds;
+	if (timeSinceLastPass < targetingInterval)
+		return;
+
+	timeSinceLastPass = 0.f;
+
+	//group the minions that want a target by team and cell so nearby minions share one query
+	for (auto& cluster : clusters)
+		cluster.Value.Reset();
+
+	for (int32 i = minions.Num() - 1; i >= 0; i--)
+	{
+		ARealmLaneMinionAI* minionAI = minions[i];
+		if (!IsValid(minionAI))
+		{
+			minions.RemoveAtSwap(i);
+			continue;
+		}
+
+		AMinionCharacter* mc = minionAI->minionCharacter;
+		if (!IsValid(mc) || !mc->IsAlive() || worldTime < minionAI->nextTargetingTime)
+			continue;
+
+		const FVector location = mc->GetActorLocation();
+		const int64 cellX = FMath::FloorToInt(location.X / MINION_TARGETING_CLUSTER_SIZE) & 0xFFFFFF;
+		const int64 cellY = FMath::FloorToInt(location.Y / MINION_TARGETING_CLUSTER_SIZE) & 0xFFFFFF;
+		const int64 clusterKey = ((int64)mc->GetTeamIndex() << 48) | (cellX << 24) | cellY;
+
+		clusters.FindOrAdd(clusterKey).Add(minionAI);
+	}
+
+	for (const auto& cluster : clusters)
+	{
+		if (cluster.Value.Num() > 0)
+			ProcessCluster(cluster.Value, characterHash);
+	}
+}
+
+void FRealmMinionTargeting::ProcessCluster(const TArray<ARealmLaneMinionAI*>& cluster, const FRealmCharacterHash& characterHash)
+{
+	//one query that covers the aggro range of every minion in the cluster
+	FBox clusterBounds(0);
+	float maxAggroDistance = 0.f;
+	for (ARealmLaneMinionAI* minionAI : cluster)
+	{
+		clusterBounds += minionAI->minionCharacter->GetActorLocation();
+		maxAggroDistance = FMath::Max(maxAggroDistance, minionAI->aggroDistance);
+	}
+
+	const FVector center = clusterBounds.GetCenter();
+	const float queryRadius = clusterBounds.GetExtent().Size2D() + maxAggroDistance;
+
+	FRealmCharacterFilter filter;
+	filter.excludedTeam = cluster[0]->minionCharacter->GetTeamIndex();
+
+	clusterCandidates.Reset();
+	characterHash.QueryRadius(center, queryRadius, filter, clusterCandidates);
+
+	for (ARealmLaneMinionAI* minionAI : cluster)
+		minionAI->ReevaluateTargets(clusterCandidates);
+}
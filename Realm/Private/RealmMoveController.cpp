@@ -2,16 +2,13 @@
 #include "RealmMoveController.h"
 #include "GameCharacter.h"
 #include "RealmCrowdComponent.h"
+#include "RealmGameMode.h"
 
 ARealmMoveController::ARealmMoveController(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer.SetDefaultSubobjectClass<URealmCrowdComponent>(TEXT("PathFollowingComponent")))
 {
-	targetRadius = objectInitializer.CreateDefaultSubobject<UPawnSensingComponent>(this, TEXT("pawnSensor"));
-	targetRadius->OnSeePawn.AddDynamic(this, &ARealmMoveController::OnTargetEnterRadius);
-	targetRadius->SightRadius = 1000.f;
-	targetRadius->bOnlySensePlayers = false;
-	targetRadius->SensingInterval = 0.25f;
-	targetRadius->SetPeripheralVisionAngle(180.f);
+	updateInterval = 0.25f;
+	nextScheduledUpdateTime = 0.f;
 }
 
 void ARealmMoveController::Possess(APawn* inPawn)
@@ -25,64 +22,43 @@ void ARealmMoveController::Possess(APawn* inPawn)
 		cc->AvoidanceGroup.SetFlagsDirectly(gc->GetTeamIndex());
 		cc->GroupsToAvoid.SetFlagsDirectly(gc->GetTeamIndex());
 		cc->UpdateCrowdAgentParams();
-
-		targetRadius->SightRadius = gc->sightRadius;
 	}
+
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+		gm->GetAIScheduler().AddController(this, GetWorld()->GetTimeSeconds());
 }
 
-void ARealmMoveController::OnTargetEnterRadius(class APawn* pawn)
+void ARealmMoveController::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	AGameCharacter* gc = Cast<AGameCharacter>(pawn);
-	AGameCharacter* mgc = Cast<AGameCharacter>(GetCharacter());
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+		gm->GetAIScheduler().RemoveController(this);
 
-	if (!IsValid(gc) || !IsValid(mgc) || !gc->IsAlive() || gc->GetTeamIndex() == mgc->GetTeamIndex())
-		return;
+	Super::EndPlay(EndPlayReason);
+}
+
+void ARealmMoveController::ScheduledUpdate()
+{
 
-	inRangeTargets.AddUnique(gc);
 }
 
 void ARealmMoveController::NeedsNewCommand()
 {
 	AGameCharacter* mgc = Cast<AGameCharacter>(GetCharacter());
-
 	if (!IsValid(mgc))
 		return;
 
-	float leastDistance = -1.f;
-	int32 leastInd = -1;
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
+		return;
 
-	for (int32 i = 0; i < inRangeTargets.Num(); i++)
-	{
-		AGameCharacter* target = inRangeTargets[i];
-		if (!IsValid(target) || (IsValid(target) && !target->IsAlive()))
-		{
-			inRangeTargets.Remove(target);
-			continue;
-		}
-
-		float distanceSq = (target->GetActorLocation() - mgc->GetActorLocation()).SizeSquared2D();
-		if (!target->IsAlive() || distanceSq > FMath::Square(targetRadius->SightRadius))
-		{
-			inRangeTargets.Remove(target);
-			continue;
-		}
-
-		if (leastDistance == -1.f)
-		{
-			leastDistance = distanceSq;
-			leastInd = i;
-			continue;
-		}
-
-		if (distanceSq < leastDistance)
-		{
-			leastDistance = distanceSq;
-			leastInd = i;
-		}
-	}
+	FRealmCharacterFilter filter;
+	filter.excludedTeam = mgc->GetTeamIndex();
 
-	if (leastInd >= 0)
-		mgc->SetCurrentTarget(inRangeTargets[leastInd]);
+	AGameCharacter* closest = gm->GetCharacterHash().FindNearest(mgc->GetActorLocation(), mgc->sightRadius, filter);
+	if (IsValid(closest))
+		mgc->SetCurrentTarget(closest);
 	else
 		mgc->StopAutoAttack();
 }
@@ -95,17 +71,20 @@ void ARealmMoveController::CharacterDamaged(AGameCharacter* damager)
 
 	if (damager->GetTeamIndex() != mc->GetTeamIndex())
 	{
+		ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+		if (!IsValid(gm))
+			return;
+
 		//get all nearby friendly units
-		for (TActorIterator<AGameCharacter> minionitr(GetWorld()); minionitr; ++minionitr)
-		{
-			AGameCharacter* mic = (*minionitr);
-			if (IsValid(mic) && mic->GetTeamIndex() == mc->GetTeamIndex())
-			{
-				float distancesq = (mic->GetActorLocation() - mc->GetActorLocation()).SizeSquared2D();
-				if (distancesq <= FMath::Square(710.f))
-					mic->ReceiveCallForHelp(mc, damager);
-			}
-		}
+		FRealmCharacterFilter filter;
+		filter.team = mc->GetTeamIndex();
+		filter.bAliveOnly = false;
+
+		TArray<AGameCharacter*> friendlies;
+		gm->GetCharacterHash().QueryRadius(mc->GetActorLocation(), 710.f, filter, friendlies);
+
+		for (AGameCharacter* mic : friendlies)
+			mic->ReceiveCallForHelp(mc, damager);
 	}
 }
 
@@ -119,6 +98,10 @@ void ARealmMoveController::GameEnded()
 	StopMovement();
 	GetWorldTimerManager().ClearAllTimersForObject(this);
 
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm))
+		gm->GetAIScheduler().RemoveController(this);
+
 	AGameCharacter* gc = Cast<AGameCharacter>(GetCharacter());
 	if (IsValid(gc))
 	{
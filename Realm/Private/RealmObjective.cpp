@@ -4,7 +4,9 @@
 ARealmObjective::ARealmObjective(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	//structures are always known to both teams
+	bAlwaysRelevant = true;
+	bUseVisionRelevancy = false;
 }
 
 void ARealmObjective::CheckDamage(FTakeHitInfo& damage)
@@ -95,7 +95,11 @@ void ARealmPlayerController::Possess(APawn* aPawn)
 					fogOfWar = NewObject<URealmFogofWarManager>(this, FName(*fogName));
 					fogOfWar->teamIndex = ps->GetTeamIndex();
 					fogOfWar->playerOwner = this;
-					fogOfWar->StartCalculatingVisibility();
+
+					//the team's vision is calculated once by the game mode and sent to each player's manager
+					ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+					if (IsValid(gm) && gm->teamFoWs.IsValidIndex(ps->GetTeamIndex()))
+						gm->teamFoWs[ps->GetTeamIndex()]->AddPlayerToManager(this);
 				}
 			}
 		}
@@ -0,0 +1,60 @@
+#include "Realm.h"
+#include "RealmProjectilePool.h"
+#include "Projectile.h"
+
+FRealmProjectilePool::FRealmProjectilePool()
+: parkedProjectiles(0), requests(0), hits(0), peakSize(0)
+{
+
+}
+
+AProjectile* FRealmProjectilePool::Acquire(UWorld* world, TSubclassOf<AProjectile> projectileClass, const FVector& location, const FRotator& rotation)
+{
+	if (!world || !*projectileClass)
+		return nullptr;
+
+	requests++;
+
+	TArray<AProjectile*>* parked = pool.Find(*projectileClass);
+	while (parked && parked->Num() > 0)
+	{
+		AProjectile* projectile = parked->Pop(false);
+		parkedProjectiles--;
+
+		if (!IsValid(projectile))
+			continue;
+
+		hits++;
+		projectile->ActivateProjectile(location, rotation);
+
+		return projectile;
+	}
+
+	AProjectile* projectile = world->SpawnActor<AProjectile>(projectileClass, location, rotation);
+	if (IsValid(projectile))
+		projectile->ActivateProjectile(location, rotation);
+
+	return projectile;
+}
+
+bool FRealmProjectilePool::Release(AProjectile* projectile)
+{
+	if (!IsValid(projectile))
+		return false;
+
+	TArray<AProjectile*>& parked = pool.FindOrAdd(projectile->GetClass());
+	if (parked.Num() >= projectile->GetClass()->GetDefaultObject<AProjectile>()->poolSize)
+		return false;
+
+	parked.Add(projectile);
+	parkedProjectiles++;
+	peakSize = FMath::Max(peakSize, parkedProjectiles);
+
+	return true;
+}
+
+void FRealmProjectilePool::Report() const
+{
+	UE_LOG(LogTemp, Log, TEXT("Projectile pool: %d requests, %.0f%% hit rate, %d misses, %d parked, %d peak parked"), requests,
+		requests > 0 ? (float)hits / requests * 100.f : 0.f, requests - hits, parkedProjectiles, peakSize);
+}
@@ -7,6 +7,10 @@ ARaiderCharacter::ARaiderCharacter(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
 	teamIndex = 3;
+
+	//raiders roam the map so they hide in the fog like any other unit
+	bAlwaysRelevant = false;
+	bUseVisionRelevancy = true;
 }
 
 void ARaiderCharacter::OnDeath(float KillingDamage, struct FDamageEvent const& DamageEvent, class APawn* InstigatingPawn, class AActor* DamageCauser, FRealmDamage& realmDamage, FDamageRecap& damageDesc)
@@ -47,7 +51,7 @@ void ARaiderCharacter::OnDeath(float KillingDamage, struct FDamageEvent const& D
 
 void ARaiderCharacter::OnRaiderRevive()
 {
-	GetStatsManager()->baseStats[(uint16)EStat::ES_HP] -= GetStatsManager()->baseStats[(uint16)EStat::ES_HP] * 0.25f;
+	GetStatsManager()->SetBaseStat(EStat::ES_HP, GetStatsManager()->GetBaseValueForStat(EStat::ES_HP) * 0.75f);
 	GetStatsManager()->SetMaxHealth();
 
 	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
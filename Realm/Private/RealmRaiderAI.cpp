@@ -1,11 +1,12 @@
 #include "Realm.h"
 #include "RealmRaiderAI.h"
 #include "RealmRaider.h"
+#include "RealmGameMode.h"
 
 ARealmRaiderAI::ARealmRaiderAI(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-
+	updateInterval = 0.8f;
 }
 
 void ARealmRaiderAI::Possess(APawn* InPawn)
@@ -18,9 +19,6 @@ void ARealmRaiderAI::Possess(APawn* InPawn)
 
 	mc->GetStatsManager()->SetMaxHealth();
 
-	FTimerHandle t;
-	GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmRaiderAI::ReevaluateTargets, 0.8f, true);
-	GetWorldTimerManager().SetTimer(t, this, &ARealmRaiderAI::CheckReachedObjective, 0.8f, true);
 	GetWorldTimerManager().SetTimer(spawnIntroTimer, 7.f, false);
 
 	spawnLocation = mc->GetActorLocation();
@@ -28,6 +26,12 @@ void ARealmRaiderAI::Possess(APawn* InPawn)
 	mc->StartDespawnTimer();
 }
 
+void ARealmRaiderAI::ScheduledUpdate()
+{
+	ReevaluateTargets();
+	CheckReachedObjective();
+}
+
 void ARealmRaiderAI::CheckReachedObjective()
 {
 	if (GetWorldTimerManager().GetTimerRemaining(spawnIntroTimer) > 0.f)
@@ -103,29 +107,20 @@ void ARealmRaiderAI::NeedsNewCommand()
 	if (!IsValid(mc))
 		return;
 
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
+		return;
+
+	const float targetRange = mc->GetCurrentValueForStat(EStat::ES_AARange) * 1.5f;
+
 	if (mc->GetTeamIndex() == 3)
 	{
-		AGameCharacter* closest = nullptr;
-		float closestDist = -1.f;
-		for (TActorIterator<AGameCharacter> chritr(GetWorld()); chritr; ++chritr)
-		{
-			AGameCharacter* gc = *chritr;
-			if (gc->IsA(ARealmObjective::StaticClass()))
-				continue;
-
-			if (IsValid(gc) && gc->IsAlive() && gc != mc)
-			{
-				float dist = (gc->GetActorLocation() - mc->GetActorLocation()).Size2D();
-				if (dist <= mc->GetCurrentValueForStat(EStat::ES_AARange) * 1.5f)
-				{
-					if (closestDist < 0.f || dist < closestDist)
-					{
-						closest = gc;
-						closestDist = dist;
-					}
-				}
-			}
-		}
+		//neutral raiders fight anything nearby except objectives
+		FRealmCharacterFilter filter;
+		filter.excludedClass = ARealmObjective::StaticClass();
+		filter.ignoredCharacter = mc;
+
+		AGameCharacter* closest = gm->GetCharacterHash().FindNearest(mc->GetActorLocation(), targetRange, filter);
 
 		if (IsValid(closest))
 		{
@@ -140,25 +135,11 @@ void ARealmRaiderAI::NeedsNewCommand()
 	}
 	else
 	{
-		AGameCharacter* closest = nullptr;
-		float closestDist = -1.f;
-		for (TActorIterator<AGameCharacter> chritr(GetWorld()); chritr; ++chritr)
-		{
-			AGameCharacter* gc = *chritr;
-
-			if (IsValid(gc) && gc->IsAlive() && gc != mc && gc->GetTeamIndex() != mc->GetTeamIndex())
-			{
-				float dist = (gc->GetActorLocation() - mc->GetActorLocation()).Size2D();
-				if (dist <= mc->GetCurrentValueForStat(EStat::ES_AARange) * 1.5f)
-				{
-					if (closestDist < 0.f || dist < closestDist)
-					{
-						closest = gc;
-						closestDist = dist;
-					}
-				}
-			}
-		}
+		FRealmCharacterFilter filter;
+		filter.excludedTeam = mc->GetTeamIndex();
+		filter.ignoredCharacter = mc;
+
+		AGameCharacter* closest = gm->GetCharacterHash().FindNearest(mc->GetActorLocation(), targetRange, filter);
 
 		if (IsValid(closest))
 		{
@@ -0,0 +1,58 @@
+#include "Realm.h"
+#include "RealmRegeneration.h"
+#include "GameCharacter.h"
+
+FRealmRegeneration::FRealmRegeneration()
+: regenInterval(0.25f), timeSinceLastPass(0.f), lastPassCount(0)
+{
+
+}
+
+void FRealmRegeneration::AddCharacter(AGameCharacter* gc)
+{
+	if (!IsValid(gc) || characterIndices.Contains(gc))
+		return;
+
+	characterIndices.Add(gc, characters.Add(gc));
+}
+
+void FRealmRegeneration::RemoveCharacter(AGameCharacter* gc)
+{
+	const int32* index = characterIndices.Find(gc);
+	if (index)
+		RemoveAt(*index);
+}
+
+void FRealmRegeneration::RemoveAt(int32 index)
+{
+	characterIndices.Remove(characters[index]);
+	characters.RemoveAtSwap(index);
+
+	if (index < characters.Num())
+		characterIndices.Add(characters[index], index);
+}
+
+void FRealmRegeneration::Update(float deltaSeconds)
+{
+	timeSinceLastPass += deltaSeconds;
+	if (timeSinceLastPass < regenInterval)
+		return;
+
+	timeSinceLastPass -= regenInterval;
+	lastPassCount = 0;
+
+	//walk backwards so dropping a character only swaps in one we've already regenerated
+	for (int32 i = characters.Num() - 1; i >= 0; i--)
+	{
+		AGameCharacter* gc = characters[i];
+		if (!IsValid(gc) || !gc->IsAlive())
+		{
+			RemoveAt(i);
+			continue;
+		}
+
+		lastPassCount++;
+		if (!gc->Regenerate(regenInterval))
+			RemoveAt(i);
+	}
+}
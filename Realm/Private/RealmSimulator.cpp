@@ -0,0 +1,85 @@
+#include "Realm.h"
+#include "RealmSimulator.h"
+
+FRealmSimulator::FRealmSimulator()
+: bEnabled(false), botsPerTeam(5), simulatedMinutes(10.f), seed(0), fixedTimeStep(1.f / 30.f), simulatedTime(0.0), wallStartTime(0.0), frameCount(0), bFinished(false)
+{
+
+}
+
+bool FRealmSimulator::ParseCommandLine()
+{
+	const TCHAR* commandLine = FCommandLine::Get();
+
+	bEnabled = FParse::Param(commandLine, TEXT("realmsim"));
+	if (!bEnabled)
+		return false;
+
+	FParse::Value(commandLine, TEXT("simbots="), botsPerTeam);
+	FParse::Value(commandLine, TEXT("simminutes="), simulatedMinutes);
+	FParse::Value(commandLine, TEXT("simseed="), seed);
+	FParse::Value(commandLine, TEXT("simstep="), fixedTimeStep);
+
+	botsPerTeam = FMath::Max(botsPerTeam, 0);
+	simulatedMinutes = FMath::Max(simulatedMinutes, 0.f);
+	fixedTimeStep = FMath::Max(fixedTimeStep, 0.001f);
+
+	return true;
+}
+
+void FRealmSimulator::Start()
+{
+	if (!bEnabled)
+		return;
+
+	FMath::RandInit(seed);
+	FMath::SRandInit(seed);
+
+	//tick the world by the same amount every frame so runs with the same seed play out the same way
+	FApp::SetFixedDeltaTime(fixedTimeStep);
+	FApp::SetUseFixedTimeStep(true);
+
+	simulatedTime = 0.0;
+	frameCount = 0;
+	wallStartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogTemp, Log, TEXT("Realm simulation: %d bots per team, %.1f minutes, seed %d, %.4f s step"), botsPerTeam, simulatedMinutes, seed, fixedTimeStep);
+}
+
+bool FRealmSimulator::Tick(float deltaSeconds)
+{
+	if (!bEnabled || bFinished)
+		return false;
+
+	simulatedTime += deltaSeconds;
+	frameCount++;
+
+	return simulatedTime >= simulatedMinutes * 60.f;
+}
+
+void FRealmSimulator::AddTiming(FName subsystem, double seconds)
+{
+	FTimingBucket* bucket = timings.Find(subsystem);
+	if (!bucket)
+	{
+		timingOrder.Add(subsystem);
+		bucket = &timings.Add(subsystem, FTimingBucket());
+	}
+
+	bucket->totalTime += seconds;
+	bucket->peakTime = FMath::Max(bucket->peakTime, seconds);
+	bucket->samples++;
+}
+
+void FRealmSimulator::Report() const
+{
+	const double wallTime = FPlatformTime::Seconds() - wallStartTime;
+	UE_LOG(LogTemp, Log, TEXT("Realm simulation finished: %.1f simulated seconds in %.1f wall seconds, %d frames"), simulatedTime, wallTime, frameCount);
+
+	for (const FName& subsystem : timingOrder)
+	{
+		const FTimingBucket& bucket = timings.FindChecked(subsystem);
+		UE_LOG(LogTemp, Log, TEXT("  %-24s total %9.2f ms  avg/frame %7.4f ms  avg/call %7.4f ms  peak %7.3f ms  calls %d"), *subsystem.ToString(), bucket.totalTime * 1000.0,
+			frameCount > 0 ? bucket.totalTime * 1000.0 / frameCount : 0.0, bucket.samples > 0 ? bucket.totalTime * 1000.0 / bucket.samples : 0.0, bucket.peakTime * 1000.0, bucket.samples);
+	}
+}
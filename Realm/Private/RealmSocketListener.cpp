@@ -6,6 +6,7 @@ FRealmSocketListener::FRealmSocketListener(FSocket* socketToListenTo, bool Login
 {
 	listenSocket = socketToListenTo;
 	bLoginSocket = LoginSocket;
+	stopEvent = FPlatformProcess::CreateSynchEvent(true);
 	listenerThread = FRunnableThread::Create(this, TEXT("FRealmSocketListener"));
 }
 
@@ -13,11 +14,97 @@ FRealmSocketListener::~FRealmSocketListener()
 {
 	delete listenerThread;
 	listenerThread = nullptr;
+
+	delete stopEvent;
+	stopEvent = nullptr;
+
+	FRealmBackendFrame* frame;
+	while (dataQueue.Dequeue(frame))
+		delete frame;
 }
 
 void FRealmSocketListener::ListenForData()
 {
+	if (recvBuffer.Num() == 0)
+		recvBuffer.SetNumUninitialized(65536);
+
+	uint32 Size;
+	bool bReadAny = false;
+	while (listenSocket->HasPendingData(Size))
+	{
+		int32 Read = 0;
+		if (!listenSocket->Recv(recvBuffer.GetData(), FMath::Min((int32)Size, recvBuffer.Num()), Read) || Read <= 0)
+			break;
+
+		ReceiveBytes(recvBuffer.GetData(), Read);
+		bytesReceived += Read;
+		bReadAny = true;
+		reads++;
+
+		if (bConnectionClosed)
+			return;
+	}
+
+	if (!bReadAny)
+	{
+		//readable with nothing pending means the other end closed the connection
+		int32 Read = 0;
+		if (!listenSocket->Recv(recvBuffer.GetData(), 1, Read) || Read == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s socket listener: connection closed"), bLoginSocket ? TEXT("login") : TEXT("multiplayer"));
+			bConnectionClosed = true;
+			return;
+		}
+
+		ReceiveBytes(recvBuffer.GetData(), Read);
+		bytesReceived += Read;
+		reads++;
+	}
+}
+
+void FRealmSocketListener::ReceiveBytes(const uint8* data, int32 size)
+{
+	if (bConnectionClosed)
+		return;
+
+	stream.Append(data, size);
 
+	//a read can hold part of a frame or several frames, only whole ones are handed over
+	const uint8* frameData;
+	int32 frameSize;
+	while (stream.PeekFrame(frameData, frameSize))
+	{
+		FRealmBackendFrame* frame = new FRealmBackendFrame();
+		frame->data.Append(frameData, frameSize);
+		frame->enqueueTime = FPlatformTime::Seconds();
+
+		dataQueue.Enqueue(frame);
+		stream.PopFrame();
+	}
+
+	//frame boundaries are lost, nothing more on this connection can be read
+	if (stream.IsCorrupt())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s socket listener: received a malformed frame, dropping the connection"), bLoginSocket ? TEXT("login") : TEXT("multiplayer"));
+		bConnectionClosed = true;
+	}
+}
+
+void FRealmSocketListener::ReportIdleStats()
+{
+	const double now = FPlatformTime::Seconds();
+	const double elapsed = now - reportStartTime;
+	if (elapsed < SOCKET_LISTENER_REPORT_INTERVAL)
+		return;
+
+	UE_LOG(LogTemp, Log, TEXT("%s socket listener: %.1f%% idle over %.0f s, %d wakeups, %d reads, %lld bytes"), bLoginSocket ? TEXT("login") : TEXT("multiplayer"),
+		elapsed > 0.0 ? idleTime / elapsed * 100.0 : 100.0, elapsed, wakeups, reads, bytesReceived);
+
+	reportStartTime = now;
+	idleTime = 0.0;
+	wakeups = 0;
+	reads = 0;
+	bytesReceived = 0;
 }
 
 bool FRealmSocketListener::Init()
@@ -27,33 +114,26 @@ bool FRealmSocketListener::Init()
 
 uint32 FRealmSocketListener::Run()
 {
-	//Initial wait before starting
-	FPlatformProcess::Sleep(0.03);
+	reportStartTime = FPlatformTime::Seconds();
 
 	while (stopListenerThread.GetValue() == 0)
 	{
-		if (!listenSocket)
-			continue;
+		const double waitStartTime = FPlatformTime::Seconds();
+		bool bReadable = false;
 
-		TArray<uint8> ReceivedData;
+		//block until there's data to read instead of spinning, waking up every so often to see if we should stop
+		if (listenSocket && !bConnectionClosed)
+			bReadable = listenSocket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(SOCKET_LISTENER_WAIT_TIME));
+		else
+			stopEvent->Wait(FTimespan::FromSeconds(SOCKET_LISTENER_WAIT_TIME));
 
-		uint32 Size;
-		while (listenSocket->HasPendingData(Size))
-		{
-			ReceivedData.SetNumUninitialized(FMath::Min(Size, 65507u));
-
-			int32 Read = 0;
-			listenSocket->Recv(ReceivedData.GetData(), ReceivedData.Num(), Read);
-		}
-		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+		idleTime += FPlatformTime::Seconds() - waitStartTime;
+		wakeups++;
 
-		if (ReceivedData.Num() <= 0)
-		{
-			//No Data Received
-			continue;
-		}
+		if (bReadable && stopListenerThread.GetValue() == 0)
+			ListenForData();
 
-		dataQueue.Enqueue(ReceivedData);
+		ReportIdleStats();
 	}
 
 	return 0;
@@ -62,6 +142,9 @@ uint32 FRealmSocketListener::Run()
 void FRealmSocketListener::Stop()
 {
 	stopListenerThread.Increment();
+
+	if (stopEvent)
+		stopEvent->Trigger();
 }
 
 void FRealmSocketListener::EnsureCompletion()
@@ -78,12 +161,15 @@ FRealmSocketListener* FRealmSocketListener::CreateListener(FSocket* socketToList
 		return nullptr;
 }
 
-void FRealmSocketListener::GetNextDataArray(TArray<uint8>& outArray)
+bool FRealmSocketListener::DequeueFrame(TArray<uint8>& outFrame, double& outEnqueueTime)
 {
-	TArray<uint8> data;
+	FRealmBackendFrame* frame;
+	if (!dataQueue.Dequeue(frame))
+		return false;
 
-	if (!dataQueue.IsEmpty())
-		dataQueue.Dequeue(data);
+	outFrame = MoveTemp(frame->data);
+	outEnqueueTime = frame->enqueueTime;
+	delete frame;
 
-	outArray = data;
-}
\ No newline at end of file
+	return true;
+}
@@ -3,6 +3,7 @@
 #include "RealmTurretAI.h"
 #include "MinionCharacter.h"
 #include "PlayerCharacter.h"
+#include "RealmGameMode.h"
 
 ATurret::ATurret(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -17,18 +18,10 @@ ATurret::ATurret(const FObjectInitializer& objectInitializer)
 	NetUpdateFrequency = 10.f;
 }
 
-void ATurret::OnSeePawn(APawn* OtherActor)
+void ATurret::AcquireTarget()
 {
-	AGameCharacter* gc = Cast<AGameCharacter>(OtherActor);
-
-	if (gc && (!gc->IsAlive() || gc->GetTeamIndex() == GetTeamIndex()))
-		return;
-
-	if (!currentTarget && IsValid(gc))
-	{
-		SetCurrentTarget(gc);
-		StartAutoAttack();
-	}
+	if (!IsValid(currentTarget))
+		TargetOutofRange();
 }
 
 void ATurret::CheckAutoAttack()
@@ -73,19 +66,21 @@ void ATurret::TargetOutofRange()
 	if (!IsValid(this))
 		return;
 
-	TArray<FHitResult> hits;
-	FVector start = GetActorLocation();
-	FVector end = start;
-	end.Z += 5.f;
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (!IsValid(gm))
+		return;
 
-	TArray<AGameCharacter*> possibleTargets;
+	FRealmCharacterFilter filter;
+	filter.excludedTeam = GetTeamIndex();
 
-	GetWorld()->SweepMultiByChannel(hits, start, end, GetActorRotation().Quaternion(), ECC_Visibility, FCollisionShape::MakeSphere(GetCurrentValueForStat(EStat::ES_AARange)));
-	for (FHitResult hit : hits)
+	TArray<AGameCharacter*> inRange;
+	gm->GetCharacterHash().QueryRadius(GetActorLocation(), GetCurrentValueForStat(EStat::ES_AARange), filter, inRange);
+
+	TArray<AGameCharacter*> possibleTargets;
+	for (AGameCharacter* gc : inRange)
 	{
-		AGameCharacter* gc = Cast<AGameCharacter>(hit.GetActor());
-		if (IsValid(gc) && gc->IsAlive() && GetTeamIndex() != gc->GetTeamIndex())
-			possibleTargets.AddUnique(gc);
+		if (HasLineOfSightTo(gc))
+			possibleTargets.Add(gc);
 	}
 
 	//first aggro any minions first
@@ -5,17 +5,12 @@
 ARealmTurretAI::ARealmTurretAI(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	pawnSensor = objectInitializer.CreateDefaultSubobject<UPawnSensingComponent>(this, TEXT("turretSensor"));
-	pawnSensor->OnSeePawn.AddDynamic(this, &ARealmTurretAI::OnSeePawn);
-	pawnSensor->SightRadius = 710.f;
-	pawnSensor->bOnlySensePlayers = false;
-	pawnSensor->SensingInterval = 0.25f;
-	pawnSensor->SetPeripheralVisionAngle(180.f);
+	updateInterval = 0.25f;
 }
 
-void ARealmTurretAI::OnSeePawn(class APawn* pawn)
+void ARealmTurretAI::ScheduledUpdate()
 {
 	ATurret* turret = Cast<ATurret>(GetPawn());
-	if (IsValid(turret))
-		turret->OnSeePawn(pawn);
+	if (IsValid(turret) && turret->IsAlive() && !IsValid(turret->GetCurrentTarget()))
+		turret->AcquireTarget();
 }
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include "Realm.h"
+#include "RealmVisibilityGrid.h"
+#include "Engine/LevelBounds.h"
+#include "AI/Navigation/NavMeshBoundsVolume.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+FRealmVisibilityGrid::FRealmVisibilityGrid()
+: gridOrigin(FVector2D::ZeroVector), cellSize(100.f), gridWidth(0), gridHeight(0)
+{
+	FMemory::Memzero(teamGenerations, sizeof(teamGenerations));
+}
+
+void FRealmVisibilityGrid::ResetVision()
+{
+	visibleCells.Init(0, gridWidth * gridHeight);
+	visionCounts.Init(0, gridWidth * gridHeight * VISION_MAX_TEAMS);
+
+	for (int32 i = 0; i < VISION_MAX_TEAMS; i++)
+		teamGenerations[i]++;
+}
+
+FBox FRealmVisibilityGrid::CalculateVisionBounds(UWorld* world)
+{
+	//the playable area of the map is wherever units can navigate
+	FBox bounds(0);
+	for (TActorIterator<ANavMeshBoundsVolume> navitr(world); navitr; ++navitr)
+		bounds += (*navitr)->GetComponentsBoundingBox(true);
+
+	if (!bounds.IsValid)
+		bounds = ALevelBounds::CalculateLevelBounds(world->PersistentLevel);
+
+	return bounds;
+}
+
+FString FRealmVisibilityGrid::GetBakeFilePath(UWorld* world, bool bShippedBake)
+{
+	const FString mapName = UWorld::RemovePIEPrefix(world->GetMapName());
+	const FString bakeDir = bShippedBake ? FPaths::GameContentDir() : FPaths::GameSavedDir();
+
+	return bakeDir / TEXT("Vision") / mapName + TEXT(".rvis");
+}
+
+void FRealmVisibilityGrid::BuildForWorld(UWorld* world, float newCellSize)
+{
+	bInitialized = false;
+	lineOfSightCache.Empty();
+
+	if (!IsValid(world) || newCellSize <= 0.f)
+		return;
+
+	const FBox bounds = CalculateVisionBounds(world);
+	if (!bounds.IsValid)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Vision grid could not find any bounds for the map, fog of war is disabled"));
+		return;
+	}
+
+	const FVector2D origin(bounds.Min.X, bounds.Min.Y);
+	const int32 width = FMath::Max(1, FMath::CeilToInt((bounds.Max.X - bounds.Min.X) / newCellSize));
+	const int32 height = FMath::Max(1, FMath::CeilToInt((bounds.Max.Y - bounds.Min.Y) / newCellSize));
+
+	//use the bake shipped with the map, then the one from a previous boot, unless we were told to rebake or the map's bounds have changed since
+	const bool bForceRebake = FParse::Param(FCommandLine::Get(), TEXT("rebakevision"));
+	if (!bForceRebake && (LoadBakeFile(GetBakeFilePath(world, true), newCellSize, origin, width, height) || LoadBakeFile(GetBakeFilePath(world, false), newCellSize, origin, width, height)))
+	{
+		ResetVision();
+		bInitialized = true;
+		return;
+	}
+
+	cellSize = newCellSize;
+	gridOrigin = origin;
+	gridWidth = width;
+	gridHeight = height;
+
+	BakeOcclusion(world, bounds);
+	ResetVision();
+	bInitialized = true;
+
+	//copy this file into Content/Vision to ship the bake with the map
+	const FString bakePath = GetBakeFilePath(world, false);
+	if (!SaveBakeFile(bakePath))
+		UE_LOG(LogTemp, Warning, TEXT("Vision grid failed to write occluder bake to %s"), *bakePath);
+}
+
+void FRealmVisibilityGrid::BakeOcclusion(UWorld* world, const FBox& bounds)
+{
+	const int32 cellCount = gridWidth * gridHeight;
+	occlusionCells.Init(0, cellCount);
+
+	//find the floor height of every cell units can walk on so we can test sight at eye level above it
+	UNavigationSystem* navSys = world->GetNavigationSystem();
+	const FVector navExtent(cellSize * 0.5f, cellSize * 0.5f, bounds.Max.Z - bounds.Min.Z);
+	TArray<float> floorHeights;
+	floorHeights.Init(bounds.Min.Z, cellCount);
+	TArray<bool> walkableCells;
+	walkableCells.Init(false, cellCount);
+	float floorTotal = 0.f;
+	int32 walkableCount = 0;
+
+	for (int32 y = 0; y < gridHeight; y++)
+	{
+		for (int32 x = 0; x < gridWidth; x++)
+		{
+			const FVector cellCenter(gridOrigin.X + (x + 0.5f) * cellSize, gridOrigin.Y + (y + 0.5f) * cellSize, bounds.GetCenter().Z);
+			FNavLocation navLoc;
+			if (navSys && navSys->ProjectPointToNavigation(cellCenter, navLoc, navExtent))
+			{
+				const int32 index = GetCellIndex(x, y);
+				floorHeights[index] = navLoc.Location.Z;
+				walkableCells[index] = true;
+				floorTotal += navLoc.Location.Z;
+				walkableCount++;
+			}
+		}
+	}
+
+	//cells that can't be walked on are tested at the average floor height of the map
+	const float averageFloor = walkableCount > 0 ? floorTotal / walkableCount : bounds.Min.Z;
+
+	FCollisionQueryParams params(FName(TEXT("VisionGridBake")), false);
+	const FCollisionShape cellShape = FCollisionShape::MakeBox(FVector(cellSize * 0.4f, cellSize * 0.4f, VISION_EYE_HEIGHT * 0.4f));
+	int32 occludedCount = 0;
+
+	for (int32 y = 0; y < gridHeight; y++)
+	{
+		for (int32 x = 0; x < gridWidth; x++)
+		{
+			const int32 index = GetCellIndex(x, y);
+			const float testHeight = (walkableCells[index] ? floorHeights[index] : averageFloor) + VISION_EYE_HEIGHT;
+			const FVector testLocation(gridOrigin.X + (x + 0.5f) * cellSize, gridOrigin.Y + (y + 0.5f) * cellSize, testHeight);
+
+			TArray<FOverlapResult> overlaps;
+			world->OverlapMultiByChannel(overlaps, testLocation, FQuat::Identity, ECC_Visibility, cellShape, params);
+
+			for (const FOverlapResult& overlap : overlaps)
+			{
+				//units never block sight, only walls, brushes and impassible geometry do
+				AActor* actor = overlap.GetActor();
+				UPrimitiveComponent* component = overlap.GetComponent();
+				if (Cast<APawn>(actor))
+					continue;
+
+				const bool bImpassible = (IsValid(actor) && actor->ActorHasTag("impassible")) || (IsValid(component) && component->ComponentHasTag("impassible"));
+				if (overlap.bBlockingHit || bImpassible)
+				{
+					occlusionCells[index] = 1;
+					occludedCount++;
+					break;
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Vision grid baked %dx%d cells of size %f, %d cells block sight"), gridWidth, gridHeight, cellSize, occludedCount);
+}
+
+bool FRealmVisibilityGrid::LoadBakeFile(const FString& filePath, float expectedCellSize, const FVector2D& expectedOrigin, int32 expectedWidth, int32 expectedHeight)
+{
+	TArray<uint8> fileData;
+	if (!FFileHelper::LoadFileToArray(fileData, *filePath, FILEREAD_Silent))
+		return false;
+
+	FMemoryReader reader(fileData);
+	int32 magic = 0, version = 0, width = 0, height = 0;
+	float bakedCellSize = 0.f;
+	FVector2D origin;
+	TArray<uint8> packedCells;
+
+	reader << magic << version;
+	if (magic != VISION_BAKE_MAGIC || version != VISION_BAKE_VERSION)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Vision grid ignoring outdated occluder bake %s"), *filePath);
+		return false;
+	}
+
+	reader << origin << bakedCellSize << width << height << packedCells;
+	if (reader.IsError() || width <= 0 || height <= 0 || !FMath::IsNearlyEqual(bakedCellSize, expectedCellSize) || packedCells.Num() != (width * height + 7) / 8)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Vision grid ignoring occluder bake %s that doesn't match this map"), *filePath);
+		return false;
+	}
+
+	//a bake from before the level was edited would give wrong sight, so only use it if it covers the same area
+	if (!origin.Equals(expectedOrigin, 1.f) || width != expectedWidth || height != expectedHeight)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Vision grid ignoring occluder bake %s, the map's bounds changed since it was baked"), *filePath);
+		return false;
+	}
+
+	gridOrigin = origin;
+	cellSize = bakedCellSize;
+	gridWidth = width;
+	gridHeight = height;
+
+	//occluders are stored as one bit per cell
+	occlusionCells.Init(0, gridWidth * gridHeight);
+	for (int32 i = 0; i < occlusionCells.Num(); i++)
+		occlusionCells[i] = (packedCells[i >> 3] >> (i & 7)) & 1;
+
+	UE_LOG(LogTemp, Log, TEXT("Vision grid loaded %dx%d cells from %s"), gridWidth, gridHeight, *filePath);
+	return true;
+}
+
+bool FRealmVisibilityGrid::SaveBakeFile(const FString& filePath) const
+{
+	TArray<uint8> packedCells;
+	packedCells.Init(0, (occlusionCells.Num() + 7) / 8);
+	for (int32 i = 0; i < occlusionCells.Num(); i++)
+	{
+		if (occlusionCells[i] != 0)
+			packedCells[i >> 3] |= 1 << (i & 7);
+	}
+
+	TArray<uint8> fileData;
+	FMemoryWriter writer(fileData);
+	int32 magic = VISION_BAKE_MAGIC, version = VISION_BAKE_VERSION, width = gridWidth, height = gridHeight;
+	float bakedCellSize = cellSize;
+	FVector2D origin = gridOrigin;
+
+	writer << magic << version << origin << bakedCellSize << width << height << packedCells;
+
+	return FFileHelper::SaveArrayToFile(fileData, *filePath);
+}
+
+bool FRealmVisibilityGrid::UpdateFootprint(FRealmVisionFootprint& footprint, int32 team, const FVector& location, float radius)
+{
+	if (!bInitialized || team < 0 || team >= VISION_MAX_TEAMS || radius <= 0.f)
+	{
+		RemoveFootprint(footprint);
+		return false;
+	}
+
+	int32 centerX, centerY;
+	if (!WorldToCell(location, centerX, centerY))
+	{
+		RemoveFootprint(footprint);
+		return false;
+	}
+
+	//moving around inside of the same cell doesn't change what we can see
+	const int32 centerCell = GetCellIndex(centerX, centerY);
+	if (footprint.centerCell == centerCell && footprint.team == team && footprint.radius == radius)
+		return false;
+
+	RemoveFootprint(footprint);
+
+	footprint.centerCell = centerCell;
+	footprint.team = team;
+	footprint.radius = radius;
+	RasterizeFootprint(footprint, centerX, centerY);
+	ApplyFootprint(footprint, true);
+
+	return true;
+}
+
+void FRealmVisibilityGrid::RemoveFootprint(FRealmVisionFootprint& footprint)
+{
+	if (footprint.centerCell == INDEX_NONE)
+		return;
+
+	if (bInitialized)
+		ApplyFootprint(footprint, false);
+
+	footprint.cells.Reset();
+	footprint.centerCell = INDEX_NONE;
+	footprint.team = INDEX_NONE;
+	footprint.radius = 0.f;
+}
+
+void FRealmVisibilityGrid::RasterizeFootprint(FRealmVisionFootprint& footprint, int32 centerX, int32 centerY) const
+{
+	footprint.cells.Reset();
+
+	const int32 cellRadius = FMath::CeilToInt(footprint.radius / cellSize);
+	const float cellRadiusSq = FMath::Square(footprint.radius / cellSize);
+
+	const int32 minX = FMath::Max(0, centerX - cellRadius), maxX = FMath::Min(gridWidth - 1, centerX + cellRadius);
+	const int32 minY = FMath::Max(0, centerY - cellRadius), maxY = FMath::Min(gridHeight - 1, centerY + cellRadius);
+
+	for (int32 y = minY; y <= maxY; y++)
+	{
+		for (int32 x = minX; x <= maxX; x++)
+		{
+			if (FMath::Square(x - centerX) + FMath::Square(y - centerY) > cellRadiusSq)
+				continue;
+
+			if (IsCellLineClear(centerX, centerY, x, y))
+				footprint.cells.Add(GetCellIndex(x, y));
+		}
+	}
+}
+
+void FRealmVisibilityGrid::ApplyFootprint(const FRealmVisionFootprint& footprint, bool bAdd)
+{
+	const int32 team = footprint.team;
+	const uint8 teamBit = 1 << team;
+
+	for (int32 cell : footprint.cells)
+	{
+		uint16& count = visionCounts[cell * VISION_MAX_TEAMS + team];
+		if (bAdd)
+		{
+			if (count++ == 0)
+				visibleCells[cell] |= teamBit;
+		}
+		else if (count > 0 && --count == 0)
+			visibleCells[cell] &= ~teamBit;
+	}
+
+	teamGenerations[team]++;
+}
+
+bool FRealmVisibilityGrid::IsCellLineClear(int32 fromX, int32 fromY, int32 toX, int32 toY) const
+{
+	//walk the cells between the two with bresenham's line, the end cell can be seen even if it blocks sight
+	const int32 dx = FMath::Abs(toX - fromX), dy = -FMath::Abs(toY - fromY);
+	const int32 stepX = fromX < toX ? 1 : -1, stepY = fromY < toY ? 1 : -1;
+	int32 error = dx + dy;
+	int32 x = fromX, y = fromY;
+
+	while (x != toX || y != toY)
+	{
+		const int32 doubleError = error * 2;
+		if (doubleError >= dy)
+		{
+			error += dy;
+			x += stepX;
+		}
+		if (doubleError <= dx)
+		{
+			error += dx;
+			y += stepY;
+		}
+
+		if (x == toX && y == toY)
+			return true;
+
+		if (occlusionCells[GetCellIndex(x, y)] != 0)
+			return false;
+	}
+
+	return true;
+}
+
+bool FRealmVisibilityGrid::IsLocationVisibleToTeam(int32 team, const FVector& location) const
+{
+	if (!bInitialized || team < 0 || team >= VISION_MAX_TEAMS)
+		return false;
+
+	int32 x, y;
+	if (!WorldToCell(location, x, y))
+		return false;
+
+	return (visibleCells[GetCellIndex(x, y)] & (1 << team)) != 0;
+}
+
+bool FRealmVisibilityGrid::HasLineOfSight(const FVector& from, const FVector& to) const
+{
+	if (!bInitialized)
+		return true;
+
+	//nothing outside of the grid can block sight
+	int32 fromX, fromY, toX, toY;
+	if (!WorldToCell(from, fromX, fromY) || !WorldToCell(to, toX, toY))
+		return true;
+
+	const int32 fromIndex = GetCellIndex(fromX, fromY), toIndex = GetCellIndex(toX, toY);
+	if (fromIndex == toIndex)
+		return true;
+
+	const uint64 cacheKey = ((uint64)fromIndex << 32) | (uint32)toIndex;
+	if (const bool* cachedResult = lineOfSightCache.Find(cacheKey))
+		return *cachedResult;
+
+	if (lineOfSightCache.Num() >= VISION_LOS_CACHE_SIZE)
+		lineOfSightCache.Empty(VISION_LOS_CACHE_SIZE);
+
+	const bool bClear = IsCellLineClear(fromX, fromY, toX, toY);
+	lineOfSightCache.Add(cacheKey, bClear);
+
+	return bClear;
+}
+
+bool FRealmVisibilityGrid::WorldToCell(const FVector& location, int32& outX, int32& outY) const
+{
+	outX = FMath::FloorToInt((location.X - gridOrigin.X) / cellSize);
+	outY = FMath::FloorToInt((location.Y - gridOrigin.Y) / cellSize);
+
+	return outX >= 0 && outY >= 0 && outX < gridWidth && outY < gridHeight;
+}
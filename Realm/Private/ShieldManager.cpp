@@ -10,14 +10,48 @@ AShieldManager::AShieldManager(const FObjectInitializer& objectInitializer)
 	bAlwaysRelevant = true;
 
 	NetUpdateFrequency = 15.f;
+
+	shieldCount = 0;
+}
+
+uint32 AShieldManager::GetDamageTypeMask(UClass* damageType, bool bRegister)
+{
+	//the built in types always get the first bits since nearly every hit uses them
+	static TArray<UClass*> damageTypeBits;
+	if (damageTypeBits.Num() == 0)
+	{
+		damageTypeBits.Add(UPhysicalDamage::StaticClass());
+		damageTypeBits.Add(USpecialDamage::StaticClass());
+		damageTypeBits.Add(UTrueDamage::StaticClass());
+	}
+
+	if (!damageType)
+		return 0;
+
+	int32 bit = damageTypeBits.Find(damageType);
+	if (bit == INDEX_NONE)
+	{
+		if (!bRegister)
+			return 0;
+
+		if (damageTypeBits.Num() >= 32)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Shield manager: out of damage type bits, shields won't absorb %s"), *damageType->GetName());
+			return 0;
+		}
+
+		bit = damageTypeBits.Add(damageType);
+	}
+
+	return 1u << bit;
 }
 
 void AShieldManager::UpdateTotalShieldAmount()
 {
 	float localTotalShield = 0.f;
 
-	for (auto& shield : shields)
-		localTotalShield += shield.Value.amount;
+	for (int32 i = 0; i < shieldCount; i++)
+		localTotalShield += shields[i].amount;
 
 	totalShieldAmount = localTotalShield;
 }
@@ -29,16 +63,74 @@ void AShieldManager::AddShield(FCharacterShield newShield)
 
 	if (newShield.amountMax > 0)
 	{
+		//a shield with the same key replaces the old one
+		for (int32 i = 0; i < shieldCount; i++)
+		{
+			if (shields[i].key == newShield.key)
+			{
+				RemoveShieldAt(i);
+				break;
+			}
+		}
+
+		//make room by dropping the shield that runs out first
+		if (shieldCount == MAX_SHIELDS)
+			RemoveShieldAt(0);
+
 		newShield.amount = newShield.amountMax;
-		shields.Add(newShield.key, newShield);
+		newShield.expireTime = newShield.duration > 0.f ? GetWorld()->GetTimeSeconds() + newShield.duration : MAX_FLT;
+
+		newShield.damageTypeMask = 0;
+		for (TSubclassOf<UDamageType> damageType : newShield.damageTypes)
+			newShield.damageTypeMask |= GetDamageTypeMask(damageType, true);
+
+		int32 index = shieldCount;
+		while (index > 0 && shields[index - 1].expireTime > newShield.expireTime)
+		{
+			shields[index] = shields[index - 1];
+			index--;
+		}
 
-		if (newShield.duration > 0.f)
-			owningCharacter->GetWorld()->GetTimerManager().SetTimer(newShield.timer, FTimerDelegate::CreateUObject(this, &AShieldManager::ShieldFinished, newShield), newShield.duration, false);
+		shields[index] = newShield;
+		shieldCount++;
 
+		UpdateExpiryTimer();
 		UpdateTotalShieldAmount();
 	}
 }
 
+void AShieldManager::RemoveShieldAt(int32 index)
+{
+	for (int32 i = index; i < shieldCount - 1; i++)
+		shields[i] = shields[i + 1];
+
+	shieldCount--;
+	shields[shieldCount] = FCharacterShield();
+}
+
+void AShieldManager::ExpireShields()
+{
+	const float worldTime = GetWorld()->GetTimeSeconds();
+
+	int32 expired = 0;
+	while (expired < shieldCount && shields[expired].expireTime <= worldTime)
+		expired++;
+
+	for (int32 i = 0; i < expired; i++)
+		RemoveShieldAt(0);
+
+	UpdateExpiryTimer();
+	UpdateTotalShieldAmount();
+}
+
+void AShieldManager::UpdateExpiryTimer()
+{
+	if (shieldCount > 0 && shields[0].expireTime < MAX_FLT)
+		GetWorldTimerManager().SetTimer(expiryTimer, this, &AShieldManager::ExpireShields, FMath::Max(shields[0].expireTime - GetWorld()->GetTimeSeconds(), KINDA_SMALL_NUMBER), false);
+	else
+		GetWorldTimerManager().ClearTimer(expiryTimer);
+}
+
 bool AShieldManager::CanAbsorbDamage() const
 {
 	return GetTotalShieldAmount() > 0;
@@ -46,23 +138,43 @@ bool AShieldManager::CanAbsorbDamage() const
 
 float AShieldManager::TryAbsorbDamage(float dmgAmount, TSubclassOf<UDamageType> dmgType)
 {
-	for (auto& shield : shields)
+	const uint32 dmgTypeMask = GetDamageTypeMask(dmgType, false);
+	if (dmgTypeMask == 0 || shieldCount == 0)
+		return dmgAmount;
+
+	//shields that run out soonest soak damage first
+	int32 writeIndex = 0;
+	for (int32 i = 0; i < shieldCount; i++)
 	{
-		if (shield.Value.damageTypes.Contains(dmgType)) //found a shield that can absorb this type of damage
+		FCharacterShield& shield = shields[i];
+		if (dmgAmount > 0.f && (shield.damageTypeMask & dmgTypeMask)) //found a shield that can absorb this type of damage
 		{
-			if (shield.Value.amount >= dmgAmount)
+			if (shield.amount > dmgAmount)
 			{
-				shield.Value.amount -= dmgAmount;
+				shield.amount -= dmgAmount;
 				dmgAmount = 0.f;
-				break;
 			}
 			else
 			{
-				dmgAmount -= shield.Value.amount;
-				shield.Value.amount = 0.f;
-				ShieldFinished(shield.Value);
+				dmgAmount -= shield.amount;
+				shield.amount = 0.f;
+				continue;
 			}
 		}
+
+		//compact the broken shields out as we go
+		if (writeIndex != i)
+			shields[writeIndex] = shield;
+		writeIndex++;
+	}
+
+	if (writeIndex != shieldCount)
+	{
+		for (int32 i = writeIndex; i < shieldCount; i++)
+			shields[i] = FCharacterShield();
+
+		shieldCount = writeIndex;
+		UpdateExpiryTimer();
 	}
 
 	UpdateTotalShieldAmount();
@@ -79,17 +191,25 @@ void AShieldManager::ShieldFinished(FCharacterShield finishingShield)
 	if (!IsValid(owningCharacter))
 		return;
 
-	owningCharacter->GetWorld()->GetTimerManager().ClearTimer(finishingShield.timer);
-	shields.Remove(finishingShield.key);
+	for (int32 i = 0; i < shieldCount; i++)
+	{
+		if (shields[i].key == finishingShield.key)
+		{
+			RemoveShieldAt(i);
+			if (i == 0)
+				UpdateExpiryTimer();
+			break;
+		}
+	}
 
 	UpdateTotalShieldAmount();
 }
 
 bool AShieldManager::DoesContainCharactersShield(AGameCharacter* originatingUnit)
 {
-	for (auto& shield : shields)
+	for (int32 i = 0; i < shieldCount; i++)
 	{
-		if (shield.Value.originatingCharacter == originatingUnit)
+		if (shields[i].originatingCharacter == originatingUnit)
 			return true;
 	}
 
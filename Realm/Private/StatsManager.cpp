@@ -3,18 +3,26 @@
 #include "UnrealNetwork.h"
 #include "Mod.h"
 #include "GameCharacter.h"
-#include "Effect.h"
 
 UStatsManager::UStatsManager(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer)
 {
 	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
+	{
 		bonusStats[i] = 0.f;
+		currentStats[i] = 0.f;
+	}
+
+	dirtyStats = MAX_uint32;
+	bEffectsDirty = false;
+	lastEffectHandle = 0;
+
+	effects.owner = this;
 }
 
 void UStatsManager::SetMaxHealth()
 {
-	health = GetCurrentValueForStat(EStat::ES_HP) + bonusStats[(uint16)EStat::ES_HP];
+	health = GetCurrentValueForStat(EStat::ES_HP);
 }
 
 void UStatsManager::SetMaxFlare()
@@ -35,14 +43,76 @@ void UStatsManager::InitializeStats(float* initBaseStats, AGameCharacter* ownerC
 	bInitialized = true;
 
 	owningCharacter = ownerChar;
+
+	MarkAllStatsDirty();
+}
+
+void UStatsManager::ResetStats(float* initBaseStats)
+{
+	RemoveAllEffects(false);
+
+	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
+	{
+		bonusStats[i] = 0.f;
+		modStats[i] = 0.f;
+	}
+
+	bInitialized = false;
+	InitializeStats(initBaseStats, owningCharacter);
 }
 
 float UStatsManager::GetCurrentValueForStat(EStat stat) const
 {
-	if (stat == EStat::ES_AARange && bonusStats[(uint8)EStat::ES_AARange] > 0)
-		stat = EStat::ES_AARange;
+	const uint32 statBit = 1u << (uint8)stat;
+	if (dirtyStats & statBit)
+	{
+		currentStats[(uint8)stat] = CalculateStat(stat);
+		dirtyStats &= ~statBit;
+	}
+
+	return currentStats[(uint8)stat];
+}
+
+void UStatsManager::MarkStatDirty(EStat stat)
+{
+	dirtyStats |= 1u << (uint8)stat;
+
+	FOnStatChanged& statChanged = statChangedDelegates[(uint8)stat];
+	if (statChanged.IsBound())
+		statChanged.Broadcast(stat, GetCurrentValueForStat(stat));
+}
+
+void UStatsManager::MarkAllStatsDirty()
+{
+	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
+		MarkStatDirty((EStat)i);
+}
+
+void UStatsManager::SetBaseStat(EStat stat, float value)
+{
+	baseStats[(uint8)stat] = value;
+	MarkStatDirty(stat);
+}
+
+void UStatsManager::AddBonusStat(EStat stat, float amount)
+{
+	bonusStats[(uint8)stat] += amount;
+	MarkStatDirty(stat);
+}
+
+void UStatsManager::ApplyEffectStats(const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float scale)
+{
+	int32 ind = 0;
+	for (TEnumAsByte<EStat> eStat : stats)
+	{
+		AddBonusStat(eStat.GetValue(), amounts[ind] * scale);
+		ind++;
+	}
+}
 
-	return baseStats[(int32)stat] + modStats[(int32)stat] + bonusStats[(int32)stat];
+void UStatsManager::OnRep_Stats()
+{
+	MarkAllStatsDirty();
 }
 
 float UStatsManager::GetBaseValueForStat(EStat stat) const
@@ -55,111 +125,196 @@ float UStatsManager::GetUnaffectedValueForStat(EStat stat) const
 	return baseStats[(int32)stat] + modStats[(int32)stat];
 }
 
-AEffect* UStatsManager::AddEffect(FText const& effectName, FText const& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration, FString const& keyName, bool bStacking, bool bMultipleInfliction, bool bPersistThroughDeath)
+bool UStatsManager::AddEffect(FText const& effectName, FText const& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration, FString const& keyName, bool bStacking, bool bMultipleInfliction, bool bPersistThroughDeath)
 {
 	if (!IsValid(owningCharacter) || (IsValid(owningCharacter) && !owningCharacter->IsAlive())) //return if the character isnt valid or dead
-		return nullptr;
-
-	if (effectsMap.Contains(keyName) && !bMultipleInfliction) //return if this effect is already inflicted and can't be inflicted multiple times
-		return nullptr;
+		return false;
+
+	FRealmEffect newEffect;
+	newEffect.amounts = amounts;
+	newEffect.stats = stats;
+	newEffect.description = effectDescription;
+	newEffect.uiName = effectName;
+	newEffect.duration = effectDuration;
+	newEffect.bStacking = bStacking;
+	newEffect.stackAmount = 0;
+	newEffect.keyName = keyName;
+	newEffect.bCanBeInflictedMultipleTimes = bMultipleInfliction;
+	newEffect.bPersistThroughDeath = bPersistThroughDeath;
+
+	return AddCreatedEffect(newEffect);
+}
 
-	AEffect* newEffect = owningCharacter->GetWorld()->SpawnActor<AEffect>(AEffect::StaticClass());
+bool UStatsManager::AddCreatedEffect(const FRealmEffect& newEffect)
+{
+	if (!IsValid(owningCharacter))
+		return false;
 
-	newEffect->amounts = amounts;
-	newEffect->stats = stats;
-	newEffect->description = effectDescription;
-	newEffect->uiName = effectName;
-	newEffect->duration = effectDuration;
-	newEffect->bStacking = bStacking;
-	newEffect->stackAmount = 0;
-	newEffect->keyName = keyName;
-	newEffect->bCanBeInflictedMultipleTimes = bMultipleInfliction;
-	newEffect->statsManager = this;
-	newEffect->bPersistThroughDeath = bPersistThroughDeath;
+	if (FindEffect(newEffect.keyName) && !newEffect.bCanBeInflictedMultipleTimes) //return if this effect is already inflicted and can't be inflicted multiple times
+		return false;
 
 	if (owningCharacter->HasAuthority())
-	{
-		int32 ind = 0;
-		for (TEnumAsByte<EStat> eStat : stats)
-		{
-			bonusStats[(int32)eStat.GetValue()] += amounts[ind];
-			ind++;
-		}
-	}
+		ApplyEffectStats(newEffect.stats, newEffect.amounts, 1.f);
 
-	effectsMap.Add(keyName, newEffect);
-	effectsList.AddUnique(newEffect);
+	FRealmEffect& effect = effects.items[effects.items.Add(newEffect)];
+	effect.effectTimer.Invalidate();
+	effect.effectHandle = ++lastEffectHandle;
 
-	if (effectDuration > 0.f)
-		owningCharacter->GetWorldTimerManager().SetTimer(newEffect->effectTimer, FTimerDelegate::CreateUObject(this, &UStatsManager::EffectFinished, keyName), effectDuration, false);
+	if (effect.duration > 0.f)
+		owningCharacter->GetWorldTimerManager().SetTimer(effect.effectTimer, FTimerDelegate::CreateUObject(this, &UStatsManager::EffectExpired, effect.effectHandle), effect.duration, false);
 
-	if (IsValid(owningCharacter) && (owningCharacter->GetWorld()->GetNetMode() == NM_Standalone || owningCharacter->GetWorld()->GetNetMode() == NM_ListenServer))
-		owningCharacter->EffectsUpdated();
+	effects.MarkItemDirty(effect);
+	NotifyEffectsUpdated();
 
-	return newEffect;
+	return true;
 }
 
 void UStatsManager::EffectFinished(FString key)
 {
-	if (!effectsMap.Contains(key) || !IsValid(owningCharacter))
-		return;
+	const int32 index = effects.items.IndexOfByPredicate([&key](const FRealmEffect& effect) { return effect.keyName == key; });
+	if (index != INDEX_NONE)
+		RemoveEffectAt(index);
+}
 
-	AEffect* effect = (*effectsMap.Find(key));
+void UStatsManager::EffectExpired(int32 effectHandle)
+{
+	const int32 index = effects.items.IndexOfByPredicate([effectHandle](const FRealmEffect& effect) { return effect.effectHandle == effectHandle; });
+	if (index != INDEX_NONE)
+		RemoveEffectAt(index);
+}
 
-	if (!IsValid(effect))
+void UStatsManager::RemoveEffectAt(int32 index)
+{
+	if (!IsValid(owningCharacter) || !effects.items.IsValidIndex(index))
 		return;
 
-	owningCharacter->GetWorldTimerManager().ClearTimer(effect->effectTimer);
+	FRealmEffect& effect = effects.items[index];
+	owningCharacter->GetWorldTimerManager().ClearTimer(effect.effectTimer);
 
 	if (owningCharacter->HasAuthority())
-	{
-		int32 ind = 0;
-		for (TEnumAsByte<EStat> eStat : effect->stats)
-		{
-			bonusStats[(int32)eStat.GetValue()] -= effect->amounts[ind];
-			ind++;
-		}
-	}
+		ApplyEffectStats(effect.stats, effect.amounts, -1.f);
 
-	effectsMap.Remove(key);
-	effectsList.Remove(effect);
+	effects.items.RemoveAt(index);
+	effects.MarkArrayDirty();
 
-	effect->Destroy(true);
-
-	if (IsValid(owningCharacter) && (owningCharacter->GetWorld()->GetNetMode() == NM_Standalone || owningCharacter->GetWorld()->GetNetMode() == NM_ListenServer))
-		owningCharacter->EffectsUpdated();
+	NotifyEffectsUpdated();
 }
 
 void UStatsManager::AddEffectStacks(const FString& effectKey, int32 stackAmount)
 {
-	if (!IsValid(owningCharacter))
+	FRealmEffect* effect = FindEffect(effectKey);
+	if (!effect)
 		return;
 
-	if (effectsMap.Contains(effectKey))
-	{
-		effectsMap[effectKey]->stackAmount += stackAmount;
+	effect->stackAmount += stackAmount;
+	effects.MarkItemDirty(*effect);
+
+	NotifyEffectsUpdated();
+}
 
-		if ((owningCharacter->GetWorld()->GetNetMode() == NM_Standalone || owningCharacter->GetWorld()->GetNetMode() == NM_ListenServer))
-			owningCharacter->EffectsUpdated();
+void UStatsManager::ResetEffectTimer(const FString& effectKey, float newTime /* = 0.f */)
+{
+	FRealmEffect* effect = FindEffect(effectKey);
+	if (!effect || !IsValid(owningCharacter))
+		return;
+
+	if (newTime != 0.f)
+		effect->duration = newTime;
+
+	effect->timerResets++;
+	owningCharacter->GetWorldTimerManager().SetTimer(effect->effectTimer, FTimerDelegate::CreateUObject(this, &UStatsManager::EffectExpired, effect->effectHandle), effect->duration, false);
+
+	effects.MarkItemDirty(*effect);
+}
+
+FRealmEffect* UStatsManager::FindEffect(const FString& effectKey)
+{
+	return effects.items.FindByPredicate([&effectKey](const FRealmEffect& effect) { return effect.keyName == effectKey; });
+}
+
+bool UStatsManager::GetEffect(const FString& effectKey, FRealmEffect& outEffect)
+{
+	FRealmEffect* effect = FindEffect(effectKey);
+	if (!effect)
+		return false;
+
+	outEffect = *effect;
+	return true;
+}
+
+float UStatsManager::GetEffectTimeRemaining(const FString& effectKey)
+{
+	FRealmEffect* effect = FindEffect(effectKey);
+	if (!effect || !IsValid(owningCharacter) || effect->duration <= 0.f)
+		return 0.f;
+
+	if (owningCharacter->HasAuthority())
+		return FMath::Max(owningCharacter->GetWorldTimerManager().GetTimerRemaining(effect->effectTimer), 0.f);
+
+	return FMath::Max(effect->duration - (owningCharacter->GetWorld()->GetTimeSeconds() - effect->localStartTime), 0.f);
+}
+
+void FRealmEffect::PreReplicatedRemove(const FRealmEffectList& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.owner))
+		InArraySerializer.owner->OnEffectReplicated(*this, true);
+}
+
+void FRealmEffect::PostReplicatedAdd(const FRealmEffectList& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.owner))
+		InArraySerializer.owner->OnEffectReplicated(*this, false);
+}
+
+void FRealmEffect::PostReplicatedChange(const FRealmEffectList& InArraySerializer)
+{
+	if (IsValid(InArraySerializer.owner))
+		InArraySerializer.owner->OnEffectReplicated(*this, false);
+}
+
+void UStatsManager::OnEffectReplicated(FRealmEffect& effect, bool bRemoved)
+{
+	//restart the local countdown when the effect shows up or the server resets its timer
+	if (!bRemoved && IsValid(owningCharacter) && (effect.localStartTime <= 0.f || effect.localTimerResets != effect.timerResets))
+	{
+		effect.localStartTime = owningCharacter->GetWorld()->GetTimeSeconds();
+		effect.localTimerResets = effect.timerResets;
 	}
+
+	//a removed item is still in the list until the batch finishes, so wait before telling the hud
+	bEffectsDirty = true;
+}
+
+void UStatsManager::FlushEffectsUpdated()
+{
+	if (!bEffectsDirty)
+		return;
+
+	bEffectsDirty = false;
+	NotifyEffectsUpdated();
 }
 
-AEffect* UStatsManager::GetEffect(const FString& effectKey)
+void UStatsManager::NotifyEffectsUpdated()
 {
-	if (effectsMap.Contains(effectKey))
-		return effectsMap[effectKey];
-	else
-		return nullptr;
+	if (IsValid(owningCharacter) && owningCharacter->GetWorld()->GetNetMode() != NM_DedicatedServer)
+		owningCharacter->EffectsUpdated();
 }
 
+
 void UStatsManager::RemoveHealth(float amount)
 {
 	health -= amount;
+
+	if (amount > 0.f && IsValid(owningCharacter))
+		owningCharacter->StartRegeneration();
 }
 
 void UStatsManager::RemoveFlare(float amount)
 {
 	flare -= amount;
+
+	if (amount > 0.f && IsValid(owningCharacter))
+		owningCharacter->StartRegeneration();
 }
 
 float UStatsManager::GetHealth() const
@@ -178,19 +333,19 @@ void UStatsManager::UpdateModStats(TArray<AMod*>& mods)
 	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
 		modStats[i] = 0.f;
 
-	if (mods.Num() <= 0)
-		return;
-
 	for (AMod* mod : mods)
 	{
 		for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
 		{
+			//attack speed mods scale with the attack speed including the mods added so far
 			if (i == (int32)EStat::ES_AtkSp)
-				modStats[i] += (GetCurrentValueForStat(EStat::ES_AtkSp) / 100.f) * mod->deltaStats[i];
+				modStats[i] += (CalculateStat(EStat::ES_AtkSp) / 100.f) * mod->deltaStats[i];
 			else
 				modStats[i] += mod->deltaStats[i];
 		}
 	}
+
+	MarkAllStatsDirty();
 }
 
 void UStatsManager::CharacterLevelUp()
@@ -207,93 +362,25 @@ void UStatsManager::CharacterLevelUp()
 	baseStats[(int32)EStat::ES_Def] += GetCurrentValueForStat(EStat::ES_DefPL);
 	baseStats[(int32)EStat::ES_SpDef] += GetCurrentValueForStat(EStat::ES_SpDefPL);
 	baseStats[(int32)EStat::ES_AtkSp] += GetCurrentValueForStat(EStat::ES_AtkSpPL);
-}
 
-void UStatsManager::OnRepUpdateEffects()
-{
-	//check for removed effects
-	for (auto it = effectsMap.CreateIterator(); it; ++it)
-	{
-		bool bEffectFound = false;
-		for (int32 i = 0; i < effectsList.Num(); i++)
-		{
-			if (!IsValid(effectsList[i]))
-				continue;
-
-			bEffectFound = effectsList[i]->GetName() == it.Key();
-
-			if (bEffectFound)
-				break;
-		}
-
-		if (!bEffectFound)
-			effectsMap.Remove(it.Key());
-	}
-
-	//add new effects
-	for (int32 i = 0; i < effectsList.Num(); i++)
-	{
-		AEffect* eff = effectsList[i];
-		if (!IsValid(eff))
-			continue;
-
-		bool bEffectFound = false;
-		for (auto it = effectsMap.CreateIterator(); it; ++it)
-			bEffectFound = it.Key() == effectsList[i]->GetName();
-
-		if (!bEffectFound)
-			effectsMap.Add(effectsList[i]->GetName(), effectsList[i]);
-	}
-
-	if (IsValid(owningCharacter))
-		owningCharacter->EffectsUpdated();
+	MarkStatDirty(EStat::ES_HP);
+	MarkStatDirty(EStat::ES_Flare);
+	MarkStatDirty(EStat::ES_HPRegen);
+	MarkStatDirty(EStat::ES_FlareRegen);
+	MarkStatDirty(EStat::ES_SpAtk);
+	MarkStatDirty(EStat::ES_Atk);
+	MarkStatDirty(EStat::ES_Def);
+	MarkStatDirty(EStat::ES_SpDef);
+	MarkStatDirty(EStat::ES_AtkSp);
 }
 
-void UStatsManager::AddCreatedEffect(AEffect* newEffect)
-{
-	if (IsValid(newEffect))
-	{
-		if (effectsMap.Contains(newEffect->keyName) && !newEffect->bCanBeInflictedMultipleTimes)
-			return;
-
-		if (owningCharacter->HasAuthority())
-		{
-			int32 ind = 0;
-			for (TEnumAsByte<EStat> eStat : newEffect->stats)
-			{
-				bonusStats[(int32)eStat.GetValue()] += newEffect->amounts[ind];
-				ind++;
-			}
-		}
-
-		effectsList.AddUnique(newEffect);
-		effectsMap.Add(newEffect->keyName, newEffect);
-
-		if (newEffect->duration > 0.f)
-			owningCharacter->GetWorldTimerManager().SetTimer(newEffect->effectTimer, FTimerDelegate::CreateUObject(this, &UStatsManager::EffectFinished, newEffect->keyName), newEffect->duration, false);
-
-		if (IsValid(owningCharacter) && (owningCharacter->GetWorld()->GetNetMode() == NM_Standalone || owningCharacter->GetWorld()->GetNetMode() == NM_ListenServer))
-			owningCharacter->EffectsUpdated();
-	}
-}
 
 void UStatsManager::RemoveAllEffects(bool bFromDeath)
 {
-	for (int32 i = 0; i < effectsList.Num(); i++)
+	for (int32 i = effects.items.Num() - 1; i >= 0; i--)
 	{
-		if (bFromDeath)
-		{
-			if (IsValid(effectsList[i]) && !effectsList[i]->bPersistThroughDeath)
-				EffectFinished(effectsList[i]->keyName);
-		}
-		else
-		{
-			if (IsValid(effectsList[i]))
-				EffectFinished(effectsList[i]->keyName);
-
-			effectsList.Empty();
-			effectsMap.Empty(0);
-		}
+		if (!bFromDeath || !effects.items[i].bPersistThroughDeath)
+			RemoveEffectAt(i);
 	}
 
 	if (IsValid(owningCharacter))
@@ -302,14 +389,14 @@ void UStatsManager::RemoveAllEffects(bool bFromDeath)
 
 void UStatsManager::RemoveNegativeEffects()
 {
-	for (int32 i = 0; i < effectsList.Num(); i++)
+	for (int32 i = effects.items.Num() - 1; i >= 0; i--)
 	{
-		if (IsValid(effectsList[i]))
+		for (float amt : effects.items[i].amounts)
 		{
-			for (float amt : effectsList[i]->amounts)
+			if (amt < 0.f)
 			{
-				if (amt < 0.f)
-					EffectFinished(effectsList[i]->keyName);
+				RemoveEffectAt(i);
+				break;
 			}
 		}
 	}
@@ -323,6 +410,6 @@ void UStatsManager::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & Out
 	DOREPLIFETIME(UStatsManager, bonusStats);
 	DOREPLIFETIME(UStatsManager, health);
 	DOREPLIFETIME(UStatsManager, flare);
-	DOREPLIFETIME(UStatsManager, effectsList);
+	DOREPLIFETIME(UStatsManager, effects);
 	DOREPLIFETIME(UStatsManager, owningCharacter);
 }
\ No newline at end of file
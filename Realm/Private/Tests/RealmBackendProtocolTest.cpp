@@ -0,0 +1,587 @@
+#include "Realm.h"
+#include "RealmBackendProtocol.h"
+#include "RealmSocketListener.h"
+
+/* values every test message is encoded with */
+static const TCHAR* TestUserid = TEXT("4815162342");
+static const TCHAR* TestPasswordHash = TEXT("5BAA61E4C9B93F3F0682250B6CF8331B7EE68FD8");
+static const TCHAR* TestEmail = TEXT("tester@mythosrealm.net");
+static const TCHAR* TestAlias = TEXT("R\u00e9alm\u00e4ker");
+static const TCHAR* TestQueue = TEXT("solo");
+static const TCHAR* TestMatchID = TEXT("match-7");
+static const TCHAR* TestMatchAddress = TEXT("127.0.0.1:7777");
+static const TCHAR* TestReason = TEXT("alias taken");
+const static int32 TEST_EXPERIENCE = 123456;
+const static int32 TEST_MYTHOS_POINTS = -17;
+const static int32 TEST_WINNING_TEAM = 1;
+
+/* amount of decoded strings that pointed outside their frame, which must never happen */
+static int32 stringsOutsideFrame = 0;
+
+/* whether a decoded string points inside the frame it was read from */
+static bool StringInFrame(const FRealmBackendString& value, const uint8* data, int32 size)
+{
+	if (value.length >= 0 && value.data >= data && value.data + value.length <= data + size)
+		return true;
+
+	stringsOutsideFrame++;
+	return false;
+}
+
+/* decode the frame with the decoder for its type, returns false if it is malformed or a decoded field points outside the frame */
+static bool DecodeAny(const uint8* data, int32 size)
+{
+	FRealmBackendReader reader(data, size);
+	switch (reader.GetType())
+	{
+	case ERealmBackendMessage::Login:
+	{
+		FRealmLoginMessage message;
+		return FRealmBackendProtocol::DecodeLogin(reader, message) && StringInFrame(message.username, data, size) && StringInFrame(message.passwordHash, data, size);
+	}
+	case ERealmBackendMessage::LoginCreate:
+	{
+		FRealmLoginCreateMessage message;
+		return FRealmBackendProtocol::DecodeLoginCreate(reader, message) && StringInFrame(message.username, data, size) && StringInFrame(message.passwordHash, data, size)
+			&& StringInFrame(message.email, data, size) && StringInFrame(message.alias, data, size);
+	}
+	case ERealmBackendMessage::GetInfoUpdate:
+	{
+		FRealmGetInfoUpdateMessage message;
+		return FRealmBackendProtocol::DecodeGetInfoUpdate(reader, message) && StringInFrame(message.userid, data, size);
+	}
+	case ERealmBackendMessage::LoginSuccess:
+	{
+		FRealmLoginSuccessMessage message;
+		return FRealmBackendProtocol::DecodeLoginSuccess(reader, message) && StringInFrame(message.userid, data, size) && StringInFrame(message.alias, data, size);
+	}
+	case ERealmBackendMessage::CreateLoginFailure:
+	{
+		FRealmCreateLoginFailureMessage message;
+		return FRealmBackendProtocol::DecodeCreateLoginFailure(reader, message) && StringInFrame(message.reason, data, size);
+	}
+	case ERealmBackendMessage::UpdateInfo:
+	{
+		FRealmUpdateInfoMessage message;
+		return FRealmBackendProtocol::DecodeUpdateInfo(reader, message) && StringInFrame(message.alias, data, size);
+	}
+	case ERealmBackendMessage::PlayerWantsMMQueue:
+	{
+		FRealmMMQueueMessage message;
+		return FRealmBackendProtocol::DecodePlayerWantsMMQueue(reader, message) && StringInFrame(message.userid, data, size) && StringInFrame(message.queue, data, size);
+	}
+	case ERealmBackendMessage::PlayerConfirmMatch:
+	{
+		FRealmConfirmMatchMessage message;
+		return FRealmBackendProtocol::DecodePlayerConfirmMatch(reader, message) && StringInFrame(message.userid, data, size) && StringInFrame(message.matchID, data, size);
+	}
+	case ERealmBackendMessage::RankedGameFinished:
+	{
+		FRealmRankedGameFinishedMessage message;
+		if (!FRealmBackendProtocol::DecodeRankedGameFinished(reader, message))
+			return false;
+
+		for (const FRealmBackendString& userid : message.userids)
+		{
+			if (!StringInFrame(userid, data, size))
+				return false;
+		}
+
+		return true;
+	}
+	case ERealmBackendMessage::FoundMatch:
+	{
+		FRealmFoundMatchMessage message;
+		return FRealmBackendProtocol::DecodeFoundMatch(reader, message) && StringInFrame(message.matchID, data, size);
+	}
+	case ERealmBackendMessage::FoundMatchConfirmed:
+	{
+		FRealmFoundMatchConfirmedMessage message;
+		return FRealmBackendProtocol::DecodeFoundMatchConfirmed(reader, message) && StringInFrame(message.matchAddress, data, size);
+	}
+	case ERealmBackendMessage::LoginFailure:
+	case ERealmBackendMessage::CreateLoginSuccess:
+	case ERealmBackendMessage::JoinedQueueSuccessfully:
+	case ERealmBackendMessage::JoinedQueueFailed:
+	case ERealmBackendMessage::MatchConfirmFailed:
+		//these have no fields, anything after the type is malformed
+		return reader.IsComplete();
+	default:
+		return false;
+	}
+}
+
+/* decode a copy of the bytes sized to fit exactly, so a read past the end lands outside the allocation where memory checkers can see it */
+static bool DecodeCopy(const uint8* data, int32 size)
+{
+	uint8* copy = size > 0 ? (uint8*)FMemory::Malloc(size) : nullptr;
+	if (copy)
+		FMemory::Memcpy(copy, data, size);
+
+	const bool bDecoded = DecodeAny(copy, size);
+	FMemory::Free(copy);
+	return bDecoded;
+}
+
+/* encode one of every message, in type order */
+static void EncodeEveryMessage(TArray<TArray<uint8> >& outFrames)
+{
+	TArray<FString> userids;
+	userids.Add(TestUserid);
+	userids.Add(FString());
+	userids.Add(TestAlias);
+
+	TArray<int32> teams;
+	teams.Add(0);
+	teams.Add(1);
+	teams.Add(1);
+
+	outFrames.Empty();
+	for (uint8 type = (uint8)ERealmBackendMessage::None + 1; type < (uint8)ERealmBackendMessage::Max; type++)
+	{
+		TArray<uint8>& frame = outFrames[outFrames.AddDefaulted()];
+		switch ((ERealmBackendMessage)type)
+		{
+		case ERealmBackendMessage::Login:
+			FRealmBackendProtocol::EncodeLogin(frame, TestUserid, TestPasswordHash);
+			break;
+		case ERealmBackendMessage::LoginCreate:
+			FRealmBackendProtocol::EncodeLoginCreate(frame, TestUserid, TestPasswordHash, TestEmail, TestAlias);
+			break;
+		case ERealmBackendMessage::GetInfoUpdate:
+			FRealmBackendProtocol::EncodeGetInfoUpdate(frame, TestUserid);
+			break;
+		case ERealmBackendMessage::LoginSuccess:
+			FRealmBackendProtocol::EncodeLoginSuccess(frame, TestUserid, TEST_EXPERIENCE, TEST_MYTHOS_POINTS, TestAlias);
+			break;
+		case ERealmBackendMessage::CreateLoginFailure:
+			FRealmBackendProtocol::EncodeCreateLoginFailure(frame, TestReason);
+			break;
+		case ERealmBackendMessage::UpdateInfo:
+			FRealmBackendProtocol::EncodeUpdateInfo(frame, TestAlias, TEST_MYTHOS_POINTS);
+			break;
+		case ERealmBackendMessage::PlayerWantsMMQueue:
+			FRealmBackendProtocol::EncodePlayerWantsMMQueue(frame, TestUserid, TestQueue);
+			break;
+		case ERealmBackendMessage::PlayerConfirmMatch:
+			FRealmBackendProtocol::EncodePlayerConfirmMatch(frame, TestUserid, TestMatchID);
+			break;
+		case ERealmBackendMessage::RankedGameFinished:
+			FRealmBackendProtocol::EncodeRankedGameFinished(frame, userids, teams, TEST_WINNING_TEAM);
+			break;
+		case ERealmBackendMessage::FoundMatch:
+			FRealmBackendProtocol::EncodeFoundMatch(frame, TestMatchID);
+			break;
+		case ERealmBackendMessage::FoundMatchConfirmed:
+			FRealmBackendProtocol::EncodeFoundMatchConfirmed(frame, TestMatchAddress);
+			break;
+		default:
+			FRealmBackendProtocol::EncodeEmpty(frame, (ERealmBackendMessage)type);
+			break;
+		}
+	}
+}
+
+/* whether the frame decodes back to the values it was encoded with */
+static bool RoundTrips(const uint8* data, int32 size)
+{
+	FRealmBackendReader reader(data, size);
+	switch (reader.GetType())
+	{
+	case ERealmBackendMessage::Login:
+	{
+		FRealmLoginMessage message;
+		return FRealmBackendProtocol::DecodeLogin(reader, message) && message.username.ToString() == TestUserid && message.passwordHash.ToString() == TestPasswordHash;
+	}
+	case ERealmBackendMessage::LoginCreate:
+	{
+		FRealmLoginCreateMessage message;
+		return FRealmBackendProtocol::DecodeLoginCreate(reader, message) && message.username.ToString() == TestUserid && message.passwordHash.ToString() == TestPasswordHash
+			&& message.email.ToString() == TestEmail && message.alias.ToString() == TestAlias;
+	}
+	case ERealmBackendMessage::GetInfoUpdate:
+	{
+		FRealmGetInfoUpdateMessage message;
+		return FRealmBackendProtocol::DecodeGetInfoUpdate(reader, message) && message.userid.ToString() == TestUserid;
+	}
+	case ERealmBackendMessage::LoginSuccess:
+	{
+		FRealmLoginSuccessMessage message;
+		return FRealmBackendProtocol::DecodeLoginSuccess(reader, message) && message.userid.ToString() == TestUserid && message.experience == TEST_EXPERIENCE
+			&& message.mythosPoints == TEST_MYTHOS_POINTS && message.alias.ToString() == TestAlias;
+	}
+	case ERealmBackendMessage::CreateLoginFailure:
+	{
+		FRealmCreateLoginFailureMessage message;
+		return FRealmBackendProtocol::DecodeCreateLoginFailure(reader, message) && message.reason.ToString() == TestReason;
+	}
+	case ERealmBackendMessage::UpdateInfo:
+	{
+		FRealmUpdateInfoMessage message;
+		return FRealmBackendProtocol::DecodeUpdateInfo(reader, message) && message.alias.ToString() == TestAlias && message.mythosPoints == TEST_MYTHOS_POINTS;
+	}
+	case ERealmBackendMessage::PlayerWantsMMQueue:
+	{
+		FRealmMMQueueMessage message;
+		return FRealmBackendProtocol::DecodePlayerWantsMMQueue(reader, message) && message.userid.ToString() == TestUserid && message.queue.ToString() == TestQueue;
+	}
+	case ERealmBackendMessage::PlayerConfirmMatch:
+	{
+		FRealmConfirmMatchMessage message;
+		return FRealmBackendProtocol::DecodePlayerConfirmMatch(reader, message) && message.userid.ToString() == TestUserid && message.matchID.ToString() == TestMatchID;
+	}
+	case ERealmBackendMessage::RankedGameFinished:
+	{
+		FRealmRankedGameFinishedMessage message;
+		return FRealmBackendProtocol::DecodeRankedGameFinished(reader, message) && message.userids.Num() == 3 && message.userids[0].ToString() == TestUserid
+			&& message.userids[1].ToString().IsEmpty() && message.userids[2].ToString() == TestAlias && message.teams.Num() == 3 && message.teams[0] == 0
+			&& message.teams[1] == 1 && message.teams[2] == 1 && message.winningTeam == TEST_WINNING_TEAM;
+	}
+	case ERealmBackendMessage::FoundMatch:
+	{
+		FRealmFoundMatchMessage message;
+		return FRealmBackendProtocol::DecodeFoundMatch(reader, message) && message.matchID.ToString() == TestMatchID;
+	}
+	case ERealmBackendMessage::FoundMatchConfirmed:
+	{
+		FRealmFoundMatchConfirmedMessage message;
+		return FRealmBackendProtocol::DecodeFoundMatchConfirmed(reader, message) && message.matchAddress.ToString() == TestMatchAddress;
+	}
+	default:
+		return DecodeAny(data, size);
+	}
+}
+
+/* pop every complete frame out of the stream, comparing each against the frame expected next */
+static bool DrainStream(FRealmBackendStream& stream, const TArray<TArray<uint8> >& frames, int32& nextFrame)
+{
+	const uint8* frameData;
+	int32 frameSize;
+	while (stream.PeekFrame(frameData, frameSize))
+	{
+		if (!frames.IsValidIndex(nextFrame))
+			return false;
+
+		const TArray<uint8>& expected = frames[nextFrame];
+		if (frameSize != expected.Num() - BACKEND_FRAME_HEADER_SIZE || FMemory::Memcmp(frameData, expected.GetData() + BACKEND_FRAME_HEADER_SIZE, frameSize) != 0)
+			return false;
+
+		stream.PopFrame();
+		nextFrame++;
+	}
+
+	return !stream.IsCorrupt();
+}
+
+/* write a frame header claiming the given size */
+static void AppendHeader(TArray<uint8>& out, uint32 frameSize)
+{
+	out.Add(frameSize & 0xff);
+	out.Add((frameSize >> 8) & 0xff);
+	out.Add((frameSize >> 16) & 0xff);
+	out.Add((frameSize >> 24) & 0xff);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRealmBackendProtocolRoundTripTest, "Realm.Backend.Protocol.RoundTrip", EAutomationTestFlags::ATF_Game)
+
+bool FRealmBackendProtocolRoundTripTest::RunTest(const FString& Parameters)
+{
+	TArray<TArray<uint8> > frames;
+	EncodeEveryMessage(frames);
+	TestTrue(TEXT("one frame per message type"), frames.Num() == (int32)ERealmBackendMessage::Max - 1);
+
+	for (int32 i = 0; i < frames.Num(); i++)
+	{
+		const TArray<uint8>& frame = frames[i];
+		const uint8* payload = frame.GetData() + BACKEND_FRAME_HEADER_SIZE;
+		const int32 payloadSize = frame.Num() - BACKEND_FRAME_HEADER_SIZE;
+		const FString type = FString::FromInt(i + 1);
+
+		FRealmBackendReader reader(payload, payloadSize);
+		TestTrue(FString::Printf(TEXT("type %s is written after the length"), *type), (int32)reader.GetType() == i + 1);
+		TestTrue(FString::Printf(TEXT("type %s round trips"), *type), RoundTrips(payload, payloadSize));
+
+		//every shorter frame is missing part of a field, so nothing may decode it
+		for (int32 truncated = 0; truncated < payloadSize; truncated++)
+		{
+			if (DecodeCopy(payload, truncated))
+				AddError(FString::Printf(TEXT("type %s decoded when truncated to %d bytes"), *type, truncated));
+		}
+
+		//trailing bytes mean the sender and receiver disagree on the layout
+		TArray<uint8> padded;
+		padded.Append(payload, payloadSize);
+		padded.Add(0);
+		TestFalse(FString::Printf(TEXT("type %s rejects trailing bytes"), *type), DecodeCopy(padded.GetData(), padded.Num()));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRealmBackendProtocolStreamTest, "Realm.Backend.Protocol.Stream", EAutomationTestFlags::ATF_Game)
+
+bool FRealmBackendProtocolStreamTest::RunTest(const FString& Parameters)
+{
+	TArray<TArray<uint8> > frames;
+	EncodeEveryMessage(frames);
+
+	TArray<uint8> wire;
+	for (const TArray<uint8>& frame : frames)
+		wire.Append(frame);
+
+	//every frame in one read
+	{
+		FRealmBackendStream stream;
+		int32 nextFrame = 0;
+		stream.Append(wire.GetData(), wire.Num());
+		TestTrue(TEXT("coalesced frames come out whole"), DrainStream(stream, frames, nextFrame) && nextFrame == frames.Num());
+	}
+
+	//split into two reads at every byte
+	for (int32 split = 0; split <= wire.Num(); split++)
+	{
+		FRealmBackendStream stream;
+		int32 nextFrame = 0;
+		stream.Append(wire.GetData(), split);
+		bool bOk = DrainStream(stream, frames, nextFrame);
+		stream.Append(wire.GetData() + split, wire.Num() - split);
+		bOk = bOk && DrainStream(stream, frames, nextFrame);
+
+		if (!bOk || nextFrame != frames.Num())
+			AddError(FString::Printf(TEXT("frames split at byte %d didn't come out whole"), split));
+	}
+
+	//one byte per read
+	{
+		FRealmBackendStream stream;
+		int32 nextFrame = 0;
+		bool bOk = true;
+		for (int32 i = 0; i < wire.Num() && bOk; i++)
+		{
+			stream.Append(wire.GetData() + i, 1);
+			bOk = DrainStream(stream, frames, nextFrame);
+		}
+
+		TestTrue(TEXT("frames read a byte at a time come out whole"), bOk && nextFrame == frames.Num());
+	}
+
+	//a frame missing its last byte waits for the rest
+	{
+		FRealmBackendStream stream;
+		const uint8* frameData;
+		int32 frameSize;
+		stream.Append(frames[0].GetData(), frames[0].Num() - 1);
+		TestFalse(TEXT("a partial frame isn't returned"), stream.PeekFrame(frameData, frameSize));
+		TestFalse(TEXT("a partial frame isn't corrupt"), stream.IsCorrupt());
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRealmBackendProtocolMalformedTest, "Realm.Backend.Protocol.Malformed", EAutomationTestFlags::ATF_Game)
+
+bool FRealmBackendProtocolMalformedTest::RunTest(const FString& Parameters)
+{
+	const uint8* frameData;
+	int32 frameSize;
+
+	//a length past the limit, an empty frame, and a length that is negative as an int all corrupt the stream
+	const uint32 badSizes[] = { (uint32)BACKEND_MAX_FRAME_SIZE + 1, 0, 0xffffffff };
+	for (uint32 badSize : badSizes)
+	{
+		FRealmBackendStream stream;
+		TArray<uint8> header;
+		AppendHeader(header, badSize);
+		header.Add((uint8)ERealmBackendMessage::LoginFailure);
+		stream.Append(header.GetData(), header.Num());
+
+		TestFalse(FString::Printf(TEXT("a frame of %u bytes isn't returned"), badSize), stream.PeekFrame(frameData, frameSize));
+		TestTrue(FString::Printf(TEXT("a frame of %u bytes corrupts the stream"), badSize), stream.IsCorrupt());
+
+		//nothing after a bad header can be trusted until the stream is reset
+		TArray<uint8> frame;
+		FRealmBackendProtocol::EncodeEmpty(frame, ERealmBackendMessage::LoginFailure);
+		stream.Append(frame.GetData(), frame.Num());
+		TestFalse(TEXT("a corrupt stream returns nothing"), stream.PeekFrame(frameData, frameSize));
+
+		stream.Reset();
+		stream.Append(frame.GetData(), frame.Num());
+		TestTrue(TEXT("a reset stream reads again"), stream.PeekFrame(frameData, frameSize) && !stream.IsCorrupt());
+	}
+
+	//the largest frame allowed still goes through
+	{
+		FRealmBackendStream stream;
+		TArray<uint8> frame;
+		AppendHeader(frame, BACKEND_MAX_FRAME_SIZE);
+		frame.AddZeroed(BACKEND_MAX_FRAME_SIZE);
+		stream.Append(frame.GetData(), frame.Num());
+		TestTrue(TEXT("a frame at the size limit is returned"), stream.PeekFrame(frameData, frameSize) && frameSize == BACKEND_MAX_FRAME_SIZE);
+	}
+
+	//lengths and counts inside a frame that point past its end
+	{
+		TArray<uint8> frame;
+		FRealmBackendWriter writer(frame, ERealmBackendMessage::FoundMatch);
+		writer.WriteInt(MAX_int32);
+		writer.Finish();
+		TestFalse(TEXT("a string longer than its frame is rejected"), DecodeCopy(frame.GetData() + BACKEND_FRAME_HEADER_SIZE, frame.Num() - BACKEND_FRAME_HEADER_SIZE));
+	}
+
+	{
+		TArray<uint8> frame;
+		FRealmBackendWriter writer(frame, ERealmBackendMessage::FoundMatch);
+		writer.WriteInt(-1);
+		writer.Finish();
+		TestFalse(TEXT("a negative string length is rejected"), DecodeCopy(frame.GetData() + BACKEND_FRAME_HEADER_SIZE, frame.Num() - BACKEND_FRAME_HEADER_SIZE));
+	}
+
+	const int32 badCounts[] = { MAX_int32, MAX_int32 / 4 + 1, -1 };
+	for (int32 badCount : badCounts)
+	{
+		TArray<uint8> userids;
+		FRealmBackendWriter useridWriter(userids, ERealmBackendMessage::RankedGameFinished);
+		useridWriter.WriteInt(badCount);
+		useridWriter.WriteInt(0);
+		useridWriter.WriteInt(0);
+		useridWriter.Finish();
+		TestFalse(FString::Printf(TEXT("a userid count of %d is rejected"), badCount), DecodeCopy(userids.GetData() + BACKEND_FRAME_HEADER_SIZE, userids.Num() - BACKEND_FRAME_HEADER_SIZE));
+
+		TArray<uint8> teams;
+		FRealmBackendWriter teamWriter(teams, ERealmBackendMessage::RankedGameFinished);
+		teamWriter.WriteInt(0);
+		teamWriter.WriteInt(badCount);
+		teamWriter.WriteInt(0);
+		teamWriter.Finish();
+		TestFalse(FString::Printf(TEXT("a team count of %d is rejected"), badCount), DecodeCopy(teams.GetData() + BACKEND_FRAME_HEADER_SIZE, teams.Num() - BACKEND_FRAME_HEADER_SIZE));
+	}
+
+	//types we don't know are never decoded
+	const uint8 badTypes[] = { (uint8)ERealmBackendMessage::None, (uint8)ERealmBackendMessage::Max, 0xff };
+	for (uint8 badType : badTypes)
+		TestFalse(FString::Printf(TEXT("type %d is rejected"), badType), DecodeCopy(&badType, 1));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRealmBackendProtocolFuzzTest, "Realm.Backend.Protocol.Fuzz", EAutomationTestFlags::ATF_Game)
+
+bool FRealmBackendProtocolFuzzTest::RunTest(const FString& Parameters)
+{
+	//fixed seed so a failure can be reproduced
+	FRandomStream random(0x5EA1);
+	stringsOutsideFrame = 0;
+
+	TArray<TArray<uint8> > frames;
+	EncodeEveryMessage(frames);
+
+	TArray<uint8> bytes;
+	for (int32 i = 0; i < 20000; i++)
+	{
+		//half the time flip bytes in a real frame, so the fuzzing reaches past the type byte
+		bytes.Reset();
+		if (random.FRand() < 0.5f)
+		{
+			const TArray<uint8>& frame = frames[random.RandRange(0, frames.Num() - 1)];
+			bytes.Append(frame.GetData() + BACKEND_FRAME_HEADER_SIZE, frame.Num() - BACKEND_FRAME_HEADER_SIZE);
+
+			const int32 flips = random.RandRange(1, 4);
+			for (int32 f = 0; f < flips; f++)
+				bytes[random.RandRange(0, bytes.Num() - 1)] = (uint8)random.RandRange(0, 255);
+
+			if (random.FRand() < 0.25f)
+				bytes.SetNum(random.RandRange(0, bytes.Num()));
+		}
+		else
+		{
+			bytes.SetNum(random.RandRange(0, 64));
+			for (int32 b = 0; b < bytes.Num(); b++)
+				bytes[b] = (uint8)random.RandRange(0, 255);
+		}
+
+		//decoding either fails or leaves every field inside the frame
+		DecodeCopy(bytes.GetData(), bytes.Num());
+
+		//the stream either returns frames inside its limits or gives up on the data
+		FRealmBackendStream stream;
+		int32 offset = 0;
+		while (offset < bytes.Num())
+		{
+			const int32 chunk = FMath::Min(random.RandRange(1, 16), bytes.Num() - offset);
+			stream.Append(bytes.GetData() + offset, chunk);
+			offset += chunk;
+
+			const uint8* frameData;
+			int32 frameSize;
+			while (stream.PeekFrame(frameData, frameSize))
+			{
+				if (frameSize < 1 || frameSize > BACKEND_MAX_FRAME_SIZE || frameSize > bytes.Num())
+				{
+					AddError(FString::Printf(TEXT("iteration %d returned a frame of %d bytes"), i, frameSize));
+					break;
+				}
+
+				DecodeCopy(frameData, frameSize);
+				stream.PopFrame();
+			}
+		}
+	}
+
+	TestTrue(TEXT("no decoded string points outside its frame"), stringsOutsideFrame == 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRealmBackendListenerCorruptTest, "Realm.Backend.Listener.Corrupt", EAutomationTestFlags::ATF_Game)
+
+bool FRealmBackendListenerCorruptTest::RunTest(const FString& Parameters)
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+		return true;
+
+	TArray<uint8> valid;
+	FRealmBackendProtocol::EncodeEmpty(valid, ERealmBackendMessage::LoginFailure);
+
+	TArray<uint8> frame;
+	double enqueueTime;
+
+	//a corrupt frame followed by a valid one, the valid one can't be trusted to line up and must not come out
+	{
+		//without a socket the listener thread only waits to be stopped, so the test can feed it bytes directly
+		FRealmSocketListener* listener = new FRealmSocketListener(nullptr, true);
+
+		TArray<uint8> bytes;
+		AppendHeader(bytes, (uint32)BACKEND_MAX_FRAME_SIZE + 1);
+		bytes.Add((uint8)ERealmBackendMessage::LoginFailure);
+		bytes.Append(valid);
+		listener->ReceiveBytes(bytes.GetData(), bytes.Num());
+
+		TestTrue(TEXT("a corrupt frame drops the connection"), listener->IsConnectionClosed());
+		TestFalse(TEXT("nothing after a corrupt frame is queued"), listener->DequeueFrame(frame, enqueueTime));
+
+		//later reads on the dropped connection are ignored too
+		listener->ReceiveBytes(valid.GetData(), valid.Num());
+		TestFalse(TEXT("a dropped connection queues nothing"), listener->DequeueFrame(frame, enqueueTime));
+
+		listener->EnsureCompletion();
+		delete listener;
+	}
+
+	//frames that arrived whole before the corrupt one are still handed over
+	{
+		FRealmSocketListener* listener = new FRealmSocketListener(nullptr, false);
+
+		TArray<uint8> bytes;
+		bytes.Append(valid);
+		AppendHeader(bytes, 0);
+		listener->ReceiveBytes(bytes.GetData(), bytes.Num());
+
+		TestTrue(TEXT("an empty frame drops the connection"), listener->IsConnectionClosed());
+		TestTrue(TEXT("the frame before it is queued"), listener->DequeueFrame(frame, enqueueTime) && frame.Num() == valid.Num() - BACKEND_FRAME_HEADER_SIZE);
+		TestFalse(TEXT("only the frame before it is queued"), listener->HasQueuedFrames());
+
+		listener->EnsureCompletion();
+		delete listener;
+	}
+
+	return true;
+}
@@ -56,6 +56,10 @@ protected:
 	UPROPERTY(replicated)
 	int32 currentAttackIndex;
 
+	/* stats manager the current attack's range is written to */
+	UPROPERTY()
+	UStatsManager* statsManager;
+
 public:
 
 	/* initialize the attack manager */
@@ -87,4 +87,22 @@ public:
 	{
 		EnsureReplicationByte++;
 	}
-};
\ No newline at end of file
+};
+
+/** every hit taken since the last net update, summed per instigator and damage type so none of them are lost */
+USTRUCT()
+struct FTakeHitBundle
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FTakeHitInfo> hits;
+
+	/** A rolling counter used to ensure the struct is dirty and will replicate. */
+	UPROPERTY()
+	uint8 bundleCounter;
+
+	FTakeHitBundle()
+		: bundleCounter(0)
+	{}
+};
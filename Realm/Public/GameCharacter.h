@@ -9,12 +9,17 @@
 #include "Mod.h"
 #include "GameCharacterData.h"
 #include "ShieldManager.h"
+#include "RealmVisibilityGrid.h"
+#include "RealmDamageOverTime.h"
 #include "GameCharacter.generated.h"
 
 /* max level for characters */
 const static int32 MAX_LEVEL = 15;
 const static float EXP_CONST = 2.f / FMath::Sqrt(128.f);
 
+/* amount of distinct hits a character can hold between net updates before the oldest is dropped */
+const static int32 MAX_PENDING_HITS = 8;
+
 class URealmFogofWarManager;
 class UOverheadWidget;
 class UUserWidget;
@@ -54,44 +59,13 @@ struct FAilmentInfo
 	FVector ailmentDir;
 };
 
-/* struct for holding damage over time info */
-USTRUCT()
-struct FDamageOverTime
+/* an attacker a character's team has brief sight of after being damaged by it */
+struct FCombatReveal
 {
-	GENERATED_USTRUCT_BODY()
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	float tickDamageTotal;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	float tickDamage;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	float tickInterval;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	float dotDuration;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	float incurredTickDamage = 0.f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	struct FDamageEvent DamageEvent;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	class AController* EventInstigator;
+	TWeakObjectPtr<AGameCharacter> attacker;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	class AActor* DamageCauser;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	FRealmDamage realmDamage; 
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	FTimerHandle dotTimer;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
-	FDamageRecap damageDesc;
+	/* world time the reveal ends */
+	float expireTime;
 };
 
 UCLASS(ABSTRACT, Blueprintable)
@@ -101,6 +75,8 @@ class AGameCharacter : public ARealmCharacter
 	friend class ARealmPlayerController;
 	friend class URealmCharacterMovementComponent;
 	friend class URealmFogofWarManager;
+	friend class FRealmDamageOverTime;
+	friend class FRealmRegeneration;
 
 	GENERATED_UCLASS_BODY()
 
@@ -146,10 +122,19 @@ protected:
 	UPROPERTY(replicated, EditAnywhere, Category = Team)
 	int32 teamIndex;
 
-	/** Replicate where this pawn was last hit and damaged */
-	UPROPERTY(Transient, ReplicatedUsing = OnRep_LastTakeHitInfo)
+	/** where this pawn was last hit and damaged */
+	UPROPERTY(Transient)
 	FTakeHitInfo lastTakeHitInfo;
 
+	/** Replicate every hit taken since the last net update */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_HitBundle)
+	FTakeHitBundle hitBundle;
+
+	/* ring buffer of hits taken since the last net update, flushed into the hit bundle in PreReplication */
+	FTakeHitInfo pendingHits[MAX_PENDING_HITS];
+	int32 pendingHitStart;
+	int32 pendingHitCount;
+
 	/* array of mods this actor currently has */
 	UPROPERTY(replicated, VisibleAnywhere, Category = Mods)
 	TArray<AMod*> mods;
@@ -287,14 +272,21 @@ protected:
 	void CharacterActionFinished();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaSeconds) override;
 
+	/* keep the movement component's max speed in step with the movement speed stat */
+	void OnMovementSpeedChanged(EStat stat, float newValue);
+
+	/* start regenerating when max health or flare changes */
+	void OnMaxResourceChanged(EStat stat, float newValue);
+
 	/** sets up the replication for taking a hit */
 	virtual void ReplicateHit(float damage, struct FDamageEvent const& damageEvent, class APawn* instigatingPawn, class AActor* damageCauser, bool bKilled, FRealmDamage& realmDamage, FDamageRecap& damageDesc);
 
 	/** play hit or death on client */
 	UFUNCTION()
-	virtual void OnRep_LastTakeHitInfo();
+	virtual void OnRep_HitBundle();
 
 	/* notify the client of Ailment */
 	UFUNCTION()
@@ -304,9 +296,8 @@ protected:
 	UFUNCTION()
 	void OnRep_AutoAttackLaunching();
 
-	/* regen functions */
-	void HealthRegen();
-	void FlareRegen();
+	/* regenerate health and flare for the interval, returns whether or not either is still below max */
+	bool Regenerate(float interval);
 
 	/** notification when killed, for both the server and client. */
 	virtual void OnDeath(float KillingDamage, struct FDamageEvent const& DamageEvent, class APawn* InstigatingPawn, class AActor* DamageCauser, FRealmDamage& realmDamage, FDamageRecap& damageDesc);
@@ -330,22 +321,48 @@ protected:
 	/* don't replicate when this unit is not visible for a player */
 	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
 
-	/* damage over time tick */
-	void DamageOverTimeTick(FString dotKey);
+	/* deal one tick of a dot to this character, called by the game mode's dot ticker */
+	void DamageOverTimeTick(const FDamageOverTime& dot);
 
-	/* array of dots currently affecting this character */
-	TMap<FString, FDamageOverTime> dotEvents;
+	/* handles of the dots currently affecting this character */
+	TArray<int32> dotHandles;
 
-	FTimerHandle clearLastHitTimer;
-	AGameCharacter* lastDamagingCharacter;
+	/* characters that have recently damaged us that we can have brief sight of, expired entries are only dropped when the reveals are read */
+	TArray<FCombatReveal> damagedSightCharacters;
+	float damagedSightTimeout;
 
-	/* clear the last take hit */
-	void ClearLastTakeHit();
+	/* reveal an attacker for the sight timeout, or extend its reveal if it already is */
+	void AddCombatReveal(AGameCharacter* attacker, float worldTime);
 
-	/* array of chraracters that we have recently damage that we can have brief sight of */
-	TMap<FName, AGameCharacter*> damagedSightCharacters;
-	float damagedSightTimeout;
-	void RemoveDamagedSightCharacter(FName charName);
+	/* add every attacker that is still revealed to the set and drop the ones that have run out */
+	void GatherCombatReveals(float worldTime, TSet<AGameCharacter*>& outRevealed);
+
+	/* cells this character currently gives its team sight of */
+	FRealmVisionFootprint visionFootprint;
+
+	/* [SERVER] bitmask of the teams that currently have sight of this character */
+	uint8 visibleTeamsMask;
+
+	/* [SERVER] time each team last lost sight of this character */
+	float teamSightLostTimes[VISION_MAX_TEAMS];
+
+	/* cached fog of war manager for this character's team so vision checks don't have to search for it */
+	UPROPERTY(Transient)
+	URealmFogofWarManager* teamVision;
+
+	/* team the cached fog of war manager was found for */
+	int32 teamVisionIndex;
+
+	/* get the fog of war manager holding this character's team vision */
+	URealmFogofWarManager* GetTeamVision();
+
+	/* whether or not this character is only replicated to players whose team can see it */
+	UPROPERTY(EditDefaultsOnly, Category = Sight)
+	bool bUseVisionRelevancy;
+
+	/* how long this character stays relevant to a team after they lose sight of it, so it doesn't pop in and out at the edge of vision */
+	UPROPERTY(EditDefaultsOnly, Category = Sight)
+	float visionRelevancyGracePeriod;
 
 public:
 
@@ -359,8 +376,6 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category=Respawn)
 	FTimerHandle respawnTimer;
 
-	FTimerHandle healthRegen, flareRegen;
-
 	/* how much damage should be mitigated from the next TakeDamage call */
 	UPROPERTY(BlueprintReadWrite, Category = Damage)
 	float nextMitigatedDamage;
@@ -397,6 +412,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = AA)
 	virtual void LaunchAutoAttack();
 
+	/* let clients draw an auto attack shot the server is simulating */
+	UFUNCTION(NetMulticast, unreliable)
+	void AllShotFired(AGameCharacter* target, TSubclassOf<AProjectile> projectileClass, FVector_NetQuantize launchLocation, float speed);
+
 	/* try to cancel any auto attacks in progress of being performed and clear current target */
 	UFUNCTION(BlueprintCallable, Category = AA)
 	virtual void StopAutoAttack(bool bClearCurrrentTarget = true);
@@ -445,7 +464,7 @@ public:
 
 	/* add buff/debuff to the player's stats */
 	UFUNCTION(BlueprintCallable, Category = Stat)
-	AEffect* AddEffect(const FText& effectName, const FText& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration = 0.f, FString const& keyName = "", bool bStacking = false, bool bMultipleInfliction = false, bool bPersistThroughDeath = false);
+	bool AddEffect(const FText& effectName, const FText& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration = 0.f, FString const& keyName = "", bool bStacking = false, bool bMultipleInfliction = false, bool bPersistThroughDeath = false);
 
 	UFUNCTION(BlueprintCallable, Category = Stat)
 	void AddEffectStacks( const FString& effectKey,  int32 stackAmount);
@@ -455,7 +474,7 @@ public:
 
 	/* damages this character over time */
 	UFUNCTION(BlueprintCallable, Category = Damage)
-	virtual void CharacterTakeDamageOverTime(float Damage, float damageTime, int32 tickCount, UPARAM(ref) FString& dotKey, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, class AActor* DamageCauser, UPARAM(ref) FRealmDamage& realmDamage, UPARAM(ref) FDamageRecap& damageDesc);
+	virtual void CharacterTakeDamageOverTime(float Damage, float damageTime, int32 tickCount, UPARAM(ref) FString& dotKey, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, class AActor* DamageCauser, UPARAM(ref) FRealmDamage& realmDamage, UPARAM(ref) FDamageRecap& damageDesc, EDoTStackPolicy stackPolicy = EDoTStackPolicy::DSP_Refresh);
 
 	/* call other things and track extra damage data */
 	UFUNCTION(BlueprintCallable, Category = Damage)
@@ -521,6 +540,9 @@ public:
 	/* stop ragdoll */
 	void StopRagdollPhysics();
 
+	/* add this character to the game mode's regeneration pass, called when it loses health or flare */
+	void StartRegeneration();
+
 	/* adds a mod to the character and updates stats */
 	UFUNCTION(BlueprintCallable, Category = Mods)
 	void AddMod(AMod* newMod);
@@ -607,8 +629,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category = CC)
 	static FAilmentInfo MakeAilmentInfo(EAilment ailment, FString ailmentString, float ailmentDuration, FVector ailmentDir);
 
-	/* called by the fog of war manager to get visibility data */
-	virtual void CalculateVisibility(TArray<AGameCharacter*>& sightList);
+	/* called by the fog of war manager to keep this character's sight footprint in the team's vision grid up to date */
+	virtual void CalculateVisibility(FRealmVisibilityGrid& visionGrid);
 
 	/* whether or not the enemy team can see this character even if its not in their sight range */
 	UFUNCTION(BlueprintCallable, Category = Vision)
@@ -729,6 +751,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Vision)
 	bool CanSeeOtherCharacter(AGameCharacter* testCharacter, bool bTestForThisCharacter = true);
 
+	/* [SERVER] called by the fog of war managers whenever a team gains or loses sight of this character */
+	void SetVisibleToTeam(int32 team, bool bVisible);
+
+	/* [SERVER] whether or not the map's baked occluders leave a clear line of sight to the other character */
+	bool HasLineOfSightTo(const AGameCharacter* otherCharacter) const;
+
 	/* set the mesh's animation rate (useful for things like pausing the character's animation) */
 	UFUNCTION(BlueprintCallable, Category = Animation)
 	void SetGloabalAnimRate(float newAnimRate);
@@ -4,6 +4,7 @@
 
 class AMinionCharacter;
 class ARealmEnabler;
+class ARealmLaneMinionAI;
 
 UCLASS()
 class ALaneManager : public AActor
@@ -56,6 +57,30 @@ protected:
 	/* level of the team this spawner is for */
 	int32 spawnMinionLevel;
 
+	/* amount of waves worth of minions (and their ai) to spawn and park when the match starts */
+	UPROPERTY(EditDefaultsOnly, Category = Pool)
+	int32 poolPrewarmWaves;
+
+	/* dead minions waiting to be reused, one list per minion class. parked minions keep their ai controller */
+	TMap<UClass*, TArray<AMinionCharacter*> > minionPool;
+
+	/* amount of minions currently parked in the pool */
+	int32 parkedMinions;
+
+	/* stats for the pool report */
+	int32 poolRequests;
+	int32 poolHits;
+	int32 poolPeakSize;
+
+	/* get a minion of the given class from the pool, or spawn a new one (with its ai) if none are parked */
+	AMinionCharacter* AcquireMinion(TSubclassOf<AMinionCharacter> minionClass);
+
+	/* spawn a new minion and its ai controller for this lane */
+	AMinionCharacter* CreateMinion(TSubclassOf<AMinionCharacter> minionClass);
+
+	/* spawn and park minions for the first few waves so the first waves don't hitch */
+	void PrewarmMinionPool();
+
 public:
 
 	/* each objective in the lane */
@@ -109,4 +134,10 @@ public:
 
 	/* sets the level of the minion spawner */
 	void SetMinionLevel(int32 newLevel);
+
+	/* park a dead minion (and its ai) so the next wave can reuse it instead of spawning a new one */
+	void ReleaseMinion(AMinionCharacter* minion);
+
+	/* log how often the minion pool was able to hand out a parked minion */
+	void ReportMinionPool() const;
 };
\ No newline at end of file
@@ -28,9 +28,25 @@ protected:
 	/* let the specific classes have different character overlays */
 	//virtual void PostRenderFor(class APlayerController* PC, class UCanvas* Canvas, FVector CameraPosition, FVector CameraDir) override;
 
-	/* to call our destroy function */
+	/* to call our destroy function, lane minions are returned to their lane's pool instead */
 	void RealmDestroy();
 
+	/* bumped every time this minion comes out of the pool so clients know to bring it back to life */
+	UPROPERTY(ReplicatedUsing = OnRep_PoolGeneration)
+	uint8 poolGeneration;
+
+	UFUNCTION()
+	void OnRep_PoolGeneration();
+
+	/* hide this minion and stop replicating it while it waits in the pool */
+	void Park();
+
+	/* bring a parked minion back to life at the spawn location with fresh stats */
+	void ResetForReuse(const FVector& location, int32 newLevel);
+
+	/* undo the death state, on both the server and clients */
+	void Revive();
+
 public:
 
 	/* called whenever a minion is under attack and needs help, if we aren't already helping try to help */
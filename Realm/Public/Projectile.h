@@ -8,6 +8,8 @@ struct FRealmDamage;
 UCLASS()
 class AProjectile : public AActor
 {
+	friend class FRealmAutoAttackShots;
+
 	GENERATED_UCLASS_BODY()
 
 protected:
@@ -43,8 +45,27 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Damage)
 	FDamageRecap damageDesc;
 
+	/* bumped whenever this projectile is parked or reused, odd while it is parked in the pool */
+	UPROPERTY(ReplicatedUsing = OnRep_PoolGeneration)
+	uint8 poolGeneration;
+
+	/* timer to send this projectile back to the pool if it never hits anything */
+	FTimerHandle expireTimer;
+
+	/* whether or not this is a client side visual for an auto attack the server simulates without an actor */
+	bool bCosmeticShot;
+
+	/*[CLIENT] hide the projectile if its owner is hidden unless we are the target */
+	void UpdateClientVisibility();
+
 	virtual void Tick(float DeltaTime) override;
-	virtual void BeginPlay() override;
+
+	/* put the movement component back to the class defaults so a reused projectile doesn't keep its last flight */
+	void ResetMovement();
+
+	/* called when the projectile is parked or reused */
+	UFUNCTION()
+	void OnRep_PoolGeneration();
 
 	/** called when projectile hits something */
 	UFUNCTION()
@@ -77,6 +98,34 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category=Projectile, replicated)
 	USoundCue* hitSound;
 
+	/* whether or not auto attacks with this projectile are simulated on the server without spawning it (turn off if the class relies on ServerProjectileCollision) */
+	UPROPERTY(EditDefaultsOnly, Category = Projectile)
+	bool bServerSimulatedShot;
+
+	/*[CLIENT] set up a local visual for a server simulated auto attack shot */
+	void InitializeCosmeticShot(AGameCharacter* shotSource, AGameCharacter* shotTarget, float speed);
+
+	/* max amount of projectiles of this class that are kept parked for reuse */
+	UPROPERTY(EditDefaultsOnly, Category = Pool)
+	int32 poolSize;
+
+	/* get a projectile from the game mode's pool (or spawn one) at the location, use this instead of spawning projectiles */
+	UFUNCTION(BlueprintCallable, Category = Projectile, meta = (WorldContext = "worldContextObject"))
+	static AProjectile* SpawnPooledProjectile(UObject* worldContextObject, TSubclassOf<AProjectile> projectileClass, const FVector& location, const FRotator& rotation);
+
+	/*[SERVER] reset this projectile and bring it into play at the location */
+	void ActivateProjectile(const FVector& location, const FRotator& rotation);
+
+	/*[SERVER] take this projectile out of play and park it in the pool (or destroy it if the pool is full) */
+	UFUNCTION(BlueprintCallable, Category = Projectile)
+	void DeactivateProjectile();
+
+	/* whether or not this projectile is parked in the pool */
+	bool IsParked() const
+	{
+		return (poolGeneration & 1) != 0;
+	}
+
 	/* initialize and launch the projectile */
 	UFUNCTION(BlueprintCallable, Category=Projectile)
 	void InitializeProjectile(const FVector& AimDir, float dmg, TSubclassOf<UDamageType> projDamage, AGameCharacter* projSpawner, AGameCharacter* projTarget, FRealmDamage const& realmDamage, float spdScale = 1.f);
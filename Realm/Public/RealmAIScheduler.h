@@ -0,0 +1,72 @@
+#pragma once
+
+class ARealmMoveController;
+
+/* runs the periodic updates of every AI controller round robin under a per frame time budget, instead of each controller owning its own timers */
+class FRealmAIScheduler
+{
+	/* every AI controller being scheduled */
+	TArray<ARealmMoveController*> controllers;
+
+	/* index of the controller the next frame starts at, so controllers skipped by the budget go first next frame */
+	int32 cursor;
+
+	/* set while Update walks the controllers, removals only clear their slot until the pass is over so the cursor stays put */
+	bool bUpdating;
+
+	/* max amount of time in milliseconds the scheduler can spend each frame, 0 for no limit */
+	float frameBudget;
+
+	/* amount of time in milliseconds the scheduler spent last frame */
+	float lastFrameTime;
+
+	/* amount of due updates that were pushed to the next frame because the budget ran out */
+	int32 lastFrameDeferred;
+
+	/* totals since the last report */
+	double reportTime;
+	int32 reportFrames;
+	int32 reportUpdates;
+	int32 reportDeferred;
+	int32 reportOverBudgetFrames;
+
+	/* time in seconds between budget reports in the log, 0 to never report */
+	float reportInterval;
+
+	/* time since the last budget report */
+	float timeSinceLastReport;
+
+	/* log how much of the budget has been used since the last report */
+	void ReportBudget();
+
+public:
+
+	FRealmAIScheduler();
+
+	/* set the max amount of time in milliseconds the scheduler can spend each frame */
+	void SetFrameBudget(float newFrameBudget);
+
+	/* set how often the scheduler logs its budget usage */
+	void SetReportInterval(float newReportInterval);
+
+	/* start scheduling updates for the controller, staggered so controllers added together don't all update on the same frame */
+	void AddController(ARealmMoveController* controller, float worldTime);
+
+	/* stop scheduling updates for the controller */
+	void RemoveController(ARealmMoveController* controller);
+
+	/* run as many due controller updates as fit in this frame's budget */
+	void Update(float deltaSeconds, float worldTime);
+
+	/* fraction of the frame budget used last frame */
+	float GetLastFrameBudgetUsage() const
+	{
+		return frameBudget > 0.f ? lastFrameTime / frameBudget : 0.f;
+	}
+
+	/* amount of due updates pushed to the next frame last frame */
+	int32 GetLastFrameDeferred() const
+	{
+		return lastFrameDeferred;
+	}
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "DamageTypes.h"
+
+class AGameCharacter;
+class AProjectile;
+class USoundCue;
+
+/* a homing auto attack in flight, simulated on the server without an actor */
+struct FRealmShot
+{
+	TWeakObjectPtr<AGameCharacter> source;
+	TWeakObjectPtr<AGameCharacter> target;
+
+	/* current position of the shot */
+	FVector location;
+
+	/* units per second the shot travels */
+	float speed;
+
+	/* distance from the target's center at which the shot lands */
+	float hitDistance;
+
+	/* time left before the shot gives up */
+	float timeRemaining;
+
+	float damage;
+	FRealmDamage realmDamage;
+	FDamageRecap damageDesc;
+	USoundCue* hitSound;
+};
+
+/* every homing auto attack in flight, moved and resolved in one batched update instead of one replicated projectile actor per attack */
+class FRealmAutoAttackShots
+{
+	/* shots in flight */
+	TArray<FRealmShot> shots;
+
+	/* shots that landed this update, resolved after the move so damage can't change the array while we walk it */
+	TArray<FRealmShot> landedShots;
+
+public:
+
+	/* launch a shot of the projectile class from the location at the source's target */
+	void FireShot(AGameCharacter* source, AGameCharacter* target, TSubclassOf<AProjectile> projectileClass, const FVector& location, float speedScale, float damage, const FRealmDamage& realmDamage, USoundCue* hitSound);
+
+	/* move every shot toward its target and deal damage for the ones that arrive */
+	void Update(float deltaSeconds);
+
+	int32 Num() const
+	{
+		return shots.Num();
+	}
+};
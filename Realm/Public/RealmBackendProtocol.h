@@ -0,0 +1,240 @@
+#pragma once
+
+/* every frame starts with the length of the rest of the frame */
+const static int32 BACKEND_FRAME_HEADER_SIZE = 4;
+
+/* largest frame we accept, anything bigger means the stream is corrupt */
+const static int32 BACKEND_MAX_FRAME_SIZE = 64 * 1024;
+
+/* type byte that follows the length of every frame */
+enum class ERealmBackendMessage : uint8
+{
+	None,
+
+	//to the login server
+	Login,
+	LoginCreate,
+	GetInfoUpdate,
+
+	//from the login server
+	LoginSuccess,
+	LoginFailure,
+	CreateLoginSuccess,
+	CreateLoginFailure,
+	UpdateInfo,
+
+	//to the multiplayer server
+	PlayerWantsMMQueue,
+	PlayerConfirmMatch,
+	RankedGameFinished,
+
+	//from the multiplayer server
+	JoinedQueueSuccessfully,
+	JoinedQueueFailed,
+	FoundMatch,
+	FoundMatchConfirmed,
+	MatchConfirmFailed,
+
+	Max
+};
+
+/* a utf8 string inside a received frame, only valid for as long as the frame is */
+struct FRealmBackendString
+{
+	const uint8* data = nullptr;
+	int32 length = 0;
+
+	FString ToString() const;
+};
+
+/* writes one frame onto the end of a buffer */
+class FRealmBackendWriter
+{
+	TArray<uint8>& buffer;
+
+	/* where this frame's length goes */
+	int32 frameStart;
+
+public:
+
+	FRealmBackendWriter(TArray<uint8>& outBuffer, ERealmBackendMessage type);
+
+	void WriteInt(int32 value);
+	void WriteString(const FString& value);
+	void WriteIntArray(const TArray<int32>& values);
+	void WriteStringArray(const TArray<FString>& values);
+
+	/* fill in the frame's length once every field is written */
+	void Finish();
+};
+
+/* reads the fields of one frame in place, without copying it */
+class FRealmBackendReader
+{
+	const uint8* data;
+	int32 size;
+	int32 offset;
+	bool bError;
+
+	bool CanRead(int32 amount);
+
+public:
+
+	/* the frame is everything after the length, starting with the type byte */
+	FRealmBackendReader(const uint8* frameData, int32 frameSize);
+
+	ERealmBackendMessage GetType() const;
+
+	bool ReadInt(int32& outValue);
+	bool ReadString(FRealmBackendString& outValue);
+	bool ReadIntArray(TArray<int32>& outValues);
+	bool ReadStringArray(TArray<FRealmBackendString>& outValues);
+
+	/* whether every field read was in bounds and the whole frame was used */
+	bool IsComplete() const
+	{
+		return !bError && offset == size;
+	}
+};
+
+/* reassembles frames from a tcp stream, which can split a frame across reads or join several into one */
+class FRealmBackendStream
+{
+	TArray<uint8> buffer;
+
+	/* start of the first frame we haven't popped yet */
+	int32 readOffset;
+
+	/* set when a frame header makes no sense, nothing after it can be trusted */
+	bool bCorrupt;
+
+public:
+
+	FRealmBackendStream();
+
+	/* add bytes received from the socket */
+	void Append(const uint8* data, int32 size);
+
+	/* point at the next complete frame without copying it, returns false until one has fully arrived */
+	bool PeekFrame(const uint8*& outData, int32& outSize);
+
+	/* drop the frame returned by PeekFrame */
+	void PopFrame();
+
+	/* throw away everything buffered */
+	void Reset();
+
+	bool IsCorrupt() const
+	{
+		return bCorrupt;
+	}
+};
+
+struct FRealmLoginMessage
+{
+	FRealmBackendString username;
+	FRealmBackendString passwordHash;
+};
+
+struct FRealmLoginCreateMessage
+{
+	FRealmBackendString username;
+	FRealmBackendString passwordHash;
+	FRealmBackendString email;
+	FRealmBackendString alias;
+};
+
+struct FRealmGetInfoUpdateMessage
+{
+	FRealmBackendString userid;
+};
+
+struct FRealmLoginSuccessMessage
+{
+	FRealmBackendString userid;
+	int32 experience = 0;
+	int32 mythosPoints = 0;
+	FRealmBackendString alias;
+};
+
+struct FRealmCreateLoginFailureMessage
+{
+	FRealmBackendString reason;
+};
+
+struct FRealmUpdateInfoMessage
+{
+	FRealmBackendString alias;
+	int32 mythosPoints = 0;
+};
+
+struct FRealmMMQueueMessage
+{
+	FRealmBackendString userid;
+	FRealmBackendString queue;
+};
+
+struct FRealmConfirmMatchMessage
+{
+	FRealmBackendString userid;
+	FRealmBackendString matchID;
+};
+
+struct FRealmRankedGameFinishedMessage
+{
+	TArray<FRealmBackendString> userids;
+	TArray<int32> teams;
+	int32 winningTeam = 0;
+};
+
+struct FRealmFoundMatchMessage
+{
+	FRealmBackendString matchID;
+};
+
+struct FRealmFoundMatchConfirmedMessage
+{
+	FRealmBackendString matchAddress;
+};
+
+/* encoders and decoders for every message the login and multiplayer servers understand, decoders return false for a malformed frame */
+class FRealmBackendProtocol
+{
+public:
+
+	/* encode a message that has no fields */
+	static void EncodeEmpty(TArray<uint8>& out, ERealmBackendMessage type);
+
+	static void EncodeLogin(TArray<uint8>& out, const FString& username, const FString& passwordHash);
+	static bool DecodeLogin(FRealmBackendReader& reader, FRealmLoginMessage& out);
+
+	static void EncodeLoginCreate(TArray<uint8>& out, const FString& username, const FString& passwordHash, const FString& email, const FString& alias);
+	static bool DecodeLoginCreate(FRealmBackendReader& reader, FRealmLoginCreateMessage& out);
+
+	static void EncodeGetInfoUpdate(TArray<uint8>& out, const FString& userid);
+	static bool DecodeGetInfoUpdate(FRealmBackendReader& reader, FRealmGetInfoUpdateMessage& out);
+
+	static void EncodeLoginSuccess(TArray<uint8>& out, const FString& userid, int32 experience, int32 mythosPoints, const FString& alias);
+	static bool DecodeLoginSuccess(FRealmBackendReader& reader, FRealmLoginSuccessMessage& out);
+
+	static void EncodeCreateLoginFailure(TArray<uint8>& out, const FString& reason);
+	static bool DecodeCreateLoginFailure(FRealmBackendReader& reader, FRealmCreateLoginFailureMessage& out);
+
+	static void EncodeUpdateInfo(TArray<uint8>& out, const FString& alias, int32 mythosPoints);
+	static bool DecodeUpdateInfo(FRealmBackendReader& reader, FRealmUpdateInfoMessage& out);
+
+	static void EncodePlayerWantsMMQueue(TArray<uint8>& out, const FString& userid, const FString& queue);
+	static bool DecodePlayerWantsMMQueue(FRealmBackendReader& reader, FRealmMMQueueMessage& out);
+
+	static void EncodePlayerConfirmMatch(TArray<uint8>& out, const FString& userid, const FString& matchID);
+	static bool DecodePlayerConfirmMatch(FRealmBackendReader& reader, FRealmConfirmMatchMessage& out);
+
+	static void EncodeRankedGameFinished(TArray<uint8>& out, const TArray<FString>& userids, const TArray<int32>& teams, int32 winningTeam);
+	static bool DecodeRankedGameFinished(FRealmBackendReader& reader, FRealmRankedGameFinishedMessage& out);
+
+	static void EncodeFoundMatch(TArray<uint8>& out, const FString& matchID);
+	static bool DecodeFoundMatch(FRealmBackendReader& reader, FRealmFoundMatchMessage& out);
+
+	static void EncodeFoundMatchConfirmed(TArray<uint8>& out, const FString& matchAddress);
+	static bool DecodeFoundMatchConfirmed(FRealmBackendReader& reader, FRealmFoundMatchConfirmedMessage& out);
+};
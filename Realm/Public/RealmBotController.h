@@ -3,8 +3,22 @@
 #include "RealmMoveController.h"
 #include "RealmBotController.generated.h"
 
+class ARealmObjective;
+
 UCLASS()
 class ARealmBotController : public ARealmMoveController
 {
 	GENERATED_UCLASS_BODY()
+
+protected:
+
+	/* enemy objective this bot is pushing towards when it has nothing to fight */
+	UPROPERTY()
+	ARealmObjective* objectiveTarget;
+
+	/* fight the closest enemy in sight, otherwise push the closest enemy objective */
+	virtual void ScheduledUpdate() override;
+
+	/* find the closest living enemy objective */
+	ARealmObjective* FindObjectiveTarget() const;
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+class AGameCharacter;
+
+/* filter for picking which characters a spatial query returns */
+struct FRealmCharacterFilter
+{
+	/* only return characters on this team, INDEX_NONE for any team */
+	int32 team = INDEX_NONE;
+
+	/* never return characters on this team, INDEX_NONE to allow every team */
+	int32 excludedTeam = INDEX_NONE;
+
+	/* only return characters of this class */
+	UClass* characterClass = nullptr;
+
+	/* never return characters of this class */
+	UClass* excludedClass = nullptr;
+
+	/* character to leave out of the results, usually the one asking */
+	const AGameCharacter* ignoredCharacter = nullptr;
+
+	/* only return characters that are alive */
+	bool bAliveOnly = true;
+
+	/* whether or not the character passes this filter */
+	bool Matches(const AGameCharacter* gc) const;
+};
+
+/* uniform grid of every live character bucketed by team, so range queries don't have to iterate every actor or sweep physics */
+class FRealmCharacterHash
+{
+	/* where a registered character currently sits in the hash */
+	struct FHashEntry
+	{
+		AGameCharacter* character;
+		int32 team;
+		int64 cellKey;
+	};
+
+	/* size of each cell in world units */
+	float cellSize;
+
+	/* every registered character */
+	TArray<FHashEntry> entries;
+
+	/* index into entries for each registered character */
+	TMap<AGameCharacter*, int32> entryIndices;
+
+	/* characters in each cell, one map for each team */
+	TMap<int32, TMap<int64, TArray<AGameCharacter*> > > teamCells;
+
+	/* get the cell coordinates for the world location */
+	FORCEINLINE void GetCell(const FVector& location, int32& outX, int32& outY) const
+	{
+		outX = FMath::FloorToInt(location.X / cellSize);
+		outY = FMath::FloorToInt(location.Y / cellSize);
+	}
+
+	FORCEINLINE static int64 MakeCellKey(int32 x, int32 y)
+	{
+		return ((int64)x << 32) | (uint32)y;
+	}
+
+	void AddToBucket(AGameCharacter* gc, int32 team, int64 cellKey);
+	void RemoveFromBucket(AGameCharacter* gc, int32 team, int64 cellKey);
+
+public:
+
+	FRealmCharacterHash();
+
+	/* set the size of the cells, characters already in the hash are moved into the new cells */
+	void SetCellSize(float newCellSize);
+
+	/* start tracking a character */
+	void AddCharacter(AGameCharacter* gc);
+
+	/* stop tracking a character */
+	void RemoveCharacter(AGameCharacter* gc);
+
+	/* move characters that changed cell or team into their new buckets, called once per frame */
+	void Update();
+
+	/* get all of the characters within the 2D radius of the center that pass the filter */
+	void QueryRadius(const FVector& center, float radius, const FRealmCharacterFilter& filter, TArray<AGameCharacter*>& outCharacters) const;
+
+	/* get up to count of the closest characters within the 2D radius that pass the filter, sorted closest first */
+	void QueryNearest(const FVector& center, float radius, int32 count, const FRealmCharacterFilter& filter, TArray<AGameCharacter*>& outCharacters) const;
+
+	/* get the closest character within the 2D radius that passes the filter */
+	AGameCharacter* FindNearest(const FVector& center, float radius, const FRealmCharacterFilter& filter) const;
+
+	/* amount of characters being tracked */
+	int32 Num() const
+	{
+		return entries.Num();
+	}
+};
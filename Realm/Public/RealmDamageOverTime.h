@@ -0,0 +1,122 @@
+#pragma once
+
+#include "DamageTypes.h"
+#include "RealmDamageOverTime.generated.h"
+
+class AGameCharacter;
+
+/* what happens when a dot is applied to a character that already has a dot with the same key */
+UENUM(BlueprintType)
+enum class EDoTStackPolicy : uint8
+{
+	DSP_Refresh UMETA(DisplayName = "Refresh Duration"),
+	DSP_Ignore UMETA(DisplayName = "Ignore"),
+	DSP_Stack UMETA(DisplayName = "Stack"),
+	DSP_Max UMETA(Hidden)
+};
+
+/* struct for holding damage over time info */
+USTRUCT()
+struct FDamageOverTime
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	float tickDamageTotal;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	float tickDamage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	float tickInterval;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	float dotDuration;
+
+	/* amount of ticks the dot deals in total */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	int32 tickCount = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	struct FDamageEvent DamageEvent;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	class AController* EventInstigator;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	class AActor* DamageCauser;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	FRealmDamage realmDamage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = DoT)
+	FDamageRecap damageDesc;
+
+	/* key the dot was applied with */
+	FString dotKey;
+
+	/* character taking the damage */
+	TWeakObjectPtr<AGameCharacter> target;
+
+	/* handle of this dot in the ticker */
+	int32 handle = INDEX_NONE;
+
+	/* ticks left before the dot ends */
+	int32 ticksRemaining = 0;
+
+	/* world time of the next tick */
+	float nextTickTime = 0.f;
+};
+
+/* every damage over time effect in the match, ticked from one pass over a flat array instead of a looping timer per dot */
+class FRealmDamageOverTime
+{
+	/* active dots, in no particular order */
+	TArray<FDamageOverTime> dots;
+
+	/* index into dots for each live handle */
+	TMap<int32, int32> handleIndices;
+
+	/* handles of the dots that are due this update, gathered first so ticks can add and remove dots safely */
+	TArray<int32> dueHandles;
+
+	int32 nextHandle;
+
+	/* amount of ticks dealt last update */
+	int32 lastFrameTicks;
+
+	/* remove the dot at the index and keep the moved dot's handle pointing at it */
+	void RemoveAt(int32 index);
+
+	/* deal one tick of the dot and schedule the next, or drop it once it runs out */
+	void TickDoT(int32 handle);
+
+public:
+
+	FRealmDamageOverTime();
+
+	/* start a dot on its target and deal the first tick straight away, returns the handle of the new dot or of the existing one the policy kept */
+	int32 ApplyDoT(FDamageOverTime& dot, EDoTStackPolicy stackPolicy);
+
+	/* get the handle of the first dot on the character with the key */
+	int32 FindDoT(const AGameCharacter* target, const FString& dotKey) const;
+
+	/* stop a dot early */
+	void RemoveDoT(int32 handle);
+
+	/* stop every dot on the character */
+	void RemoveTarget(AGameCharacter* target);
+
+	/* deal every tick that is due */
+	void Update(float worldTime);
+
+	int32 Num() const
+	{
+		return dots.Num();
+	}
+
+	int32 GetLastFrameTicks() const
+	{
+		return lastFrameTicks;
+	}
+};
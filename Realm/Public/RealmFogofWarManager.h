@@ -5,6 +5,63 @@
 class AGameCharacter;
 class ARealmPlayerController;
 class ARealmGameMode;
+class URealmFogofWarManager;
+
+/* single character in a team's sight list */
+USTRUCT()
+struct FRealmSightEntry : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* character the team has sight of */
+	UPROPERTY()
+	AGameCharacter* character;
+
+	/* [CLIENT] called when a character leaves or enters sight */
+	void PreReplicatedRemove(const struct FRealmSightList& InArraySerializer);
+	void PostReplicatedAdd(const struct FRealmSightList& InArraySerializer);
+	void PostReplicatedChange(const struct FRealmSightList& InArraySerializer);
+};
+
+/* list of characters a team can see, replicated as deltas so only the units that entered or left sight are sent */
+USTRUCT()
+struct FRealmSightList : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FRealmSightEntry> items;
+
+	/* fog of war manager this list belongs to */
+	URealmFogofWarManager* owner;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FastArrayDeltaSerialize<FRealmSightEntry>(items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FRealmSightList> : public TStructOpsTypeTraitsBase
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/* cached result of testing an enemy against the team's vision grid */
+struct FRealmEnemyVisionState
+{
+	/* cell the enemy was in when it was last tested */
+	int32 cellX = INDEX_NONE, cellY = INDEX_NONE;
+
+	/* whether or not the grid gave sight of the enemy */
+	bool bGridVisible = false;
+
+	/* visibility pass this enemy was last seen in, so stale entries can be dropped */
+	uint32 lastPass = 0;
+};
 
 UCLASS()
 class URealmFogofWarManager : public UObject
@@ -16,17 +73,42 @@ protected:
 	/* array of game characters that use this manager */
 	TArray<AGameCharacter*> teamCharacters;
 
-	/* array of player controllers that use the vision */
-	//TArray<ARealmPlayerController*> teamPlayers;
+	/* array of player controllers whose fog of war managers receive this team's vision */
+	UPROPERTY()
+	TArray<ARealmPlayerController*> teamPlayers;
 
 	/* timer that calls for characters on the team to calculate visibiltiy */
 	FTimerHandle visibilityTimer;
 
+	/* characters the team currently has sight of, mirrors enemySightList for fast lookups on both the server and clients, weak so a destroyed character is never dereferenced before it is dropped */
+	TSet<TWeakObjectPtr<AGameCharacter> > sightSet;
+
+	/* [CLIENT] whether or not every character has been hidden or shown once, after that only changes are applied */
+	bool bAppliedInitialSight = false;
+
+	/* last grid result for each enemy so only enemies that moved or saw the team's vision change are tested again */
+	TMap<TWeakObjectPtr<AGameCharacter>, FRealmEnemyVisionState> enemyVisionStates;
+
+	/* vision generation of the grid the last time we calculated visibility */
+	uint32 lastVisionGeneration = 0;
+
+	/* incremented every time visibility is calculated */
+	uint32 visibilityPass = 0;
+
 	/* tell all of the characters to calculate visibility */
 	void CalculateTeamVisibility();
 
-	UFUNCTION()
-	void OnRep_EnemySightList();
+	/* add or remove a character from the sight list if its visibility changed */
+	void SetCharacterVisible(AGameCharacter* gc, bool bVisible);
+
+	/* add or remove a character from this manager's own sight list without touching the character */
+	void UpdateSightList(AGameCharacter* gc, bool bVisible);
+
+	/* drop any characters that have left the game from the sight list */
+	void RemoveInvalidSightEntries();
+
+	/* [CLIENT] hide or show a character and everything attached to it */
+	void ApplyCharacterSight(AGameCharacter* gc, bool bVisible);
 
 public:
 
@@ -41,9 +123,21 @@ public:
 	UPROPERTY()
 	ARealmGameMode* gameOwner;
 
-	/* array of units that this player can see and is used for updating vision in-game */
-	UPROPERTY(ReplicatedUsing=OnRep_EnemySightList)
-	TArray<AGameCharacter*> enemySightList;
+	/* list of units that this player can see and is used for updating vision in-game */
+	UPROPERTY(Replicated)
+	FRealmSightList enemySightList;
+
+	/* whether or not the team has sight of the character */
+	bool IsCharacterVisible(AGameCharacter* gc) const
+	{
+		return sightSet.Contains(gc);
+	}
+
+	/* [CLIENT] called by the sight list when a character enters or leaves sight */
+	void OnCharacterSightChanged(AGameCharacter* gc, bool bVisible);
+
+	/* [CLIENT] hide a character that spawned after the sight list was applied if we can't see it */
+	void InitializeCharacterSight(AGameCharacter* gc);
 
 	/* called whenever we need to add a character to the manager */
 	void AddCharacterToManager(AGameCharacter* newCharacter);
@@ -51,10 +145,10 @@ public:
 	/* called whenever we need to remove a character from the manager */
 	void RemoveCharacterFromManager(AGameCharacter* oldCharacter);
 
-	/* add a player to the manager */
+	/* subscribe a player to this team's vision so it is sent to their own fog of war manager */
 	void AddPlayerToManager(ARealmPlayerController* newPlayer);
 
-	/* starts the timer for calculating unit visibility */
+	/* [SERVER] starts the timer for calculating the team's visibility, only the game mode's team managers calculate vision */
 	void StartCalculatingVisibility();
 
 	virtual bool IsSupportedForNetworking() const override
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "RealmMoveController.h"
-#include "Runtime/AIModule/Classes/Perception/PawnSensingComponent.h"
 #include "RealmForestMinionAI.generated.h"
 
 class ALaneManager;
@@ -29,6 +28,8 @@ protected:
 	/* target out of aggro range */
 	void ReevaluateTargets();
 
+	virtual void ScheduledUpdate() override;
+
 public:
 
 	/* home vector of this minion */
@@ -11,7 +11,7 @@
 
 class ARealmGameMode;
 
-UCLASS()
+UCLASS(config=Game)
 class URealmGameInstance : public UGameInstance
 {
 	GENERATED_UCLASS_BODY()
@@ -49,10 +49,100 @@ protected:
 
 	FTimerHandle loginSocketListenTimer, multiplayerSocketListenTimer;
 
-	FString StringFromBinaryArray(const TArray<uint8>& BinaryArray);
+	/* host name or ip of the login and multiplayer servers, -backendhost= overrides it */
+	UPROPERTY(config)
+	FString backendHost;
 
-	void SetupInternetAddresses();
+	/* port of the login server, -loginport= overrides it */
+	UPROPERTY(config)
+	int32 loginPort;
 
+	/* port of the multiplayer server, -multiplayerport= overrides it */
+	UPROPERTY(config)
+	int32 multiplayerPort;
+
+	/* seconds a resolved backend address is reused before looking the host up again */
+	UPROPERTY(config)
+	float backendAddressTTL;
+
+	/* seconds a backend socket may take to connect before giving up on it */
+	UPROPERTY(config)
+	float backendConnectTimeout;
+
+	/* lookup of the backend host that is still running, polled instead of waited on */
+	FResolveInfo* pendingResolve;
+
+	/* polls the lookup and the connecting sockets while any of them are outstanding */
+	FTimerHandle backendPollTimer;
+
+	/* sockets still connecting, only handed to a listener once they are connected */
+	FSocket* connectingLoginSocket;
+	FSocket* connectingMultiplayerSocket;
+	double loginConnectStartTime;
+	double multiplayerConnectStartTime;
+
+	/* last resolved backend address and when it was resolved */
+	uint32 cachedBackendIp;
+	double cachedBackendIpTime;
+
+	/* whether a socket is waiting on the lookup to connect */
+	bool bLoginConnectPending;
+	bool bMultiplayerConnectPending;
+
+	/* frames sent before their socket connected, sent in order once it does */
+	TArray<TArray<uint8> > pendingLoginFrames;
+	TArray<TArray<uint8> > pendingMultiplayerFrames;
+
+	/* milliseconds each poll may spend handling queued backend messages before leaving the rest for the next poll */
+	UPROPERTY(EditDefaultsOnly, Category = Backend)
+	float socketPollBudget;
+
+	/* time between queueing a backend message and handling it, for the current report */
+	double messageLatencyTotal;
+	double messageLatencyPeak;
+	int32 messagesHandled;
+	int32 pollsOverBudget;
+	double latencyReportStartTime;
+
+	/* handle every message the listener has queued, or as many as fit in the poll budget, returns the amount handled */
+	int32 DrainSocket(FRealmSocketListener* listener, bool bLoginSocket);
+
+	/* stop a listener whose connection is done with and destroy its socket, the next send connects again */
+	void CloseBackendSocket(FRealmSocketListener*& listener, FSocket*& socket, FTimerHandle& listenTimer);
+
+	/* log the backend message latency every so often */
+	void ReportMessageLatency();
+
+	/* send a whole encoded frame to one of the backend servers */
+	bool SendFrame(FSocket* socket, const TArray<uint8>& frame);
+
+	/* send a frame now if the socket is connected, otherwise hold on to it and start connecting */
+	bool SendLoginFrame(const TArray<uint8>& frame);
+	bool SendMultiplayerFrame(const TArray<uint8>& frame);
+
+	/* get the backend address from the cache, or start looking it up and connect the pending sockets when it finishes */
+	bool ResolveBackendHost();
+	void FinishBackendResolve();
+	void OnBackendHostResolved(uint32 ip);
+
+	/* check on the lookup and the connecting sockets, stopping once nothing is outstanding */
+	void PollBackend();
+	void StartBackendPoll();
+
+	/* create a non-blocking socket and start connecting it to the backend address, returns null if it couldn't start */
+	FSocket* OpenBackendSocket(const FString& socketName, uint32 ip, int32 port);
+
+	/* state of a connecting socket, a connection that takes longer than the timeout counts as an error */
+	ESocketConnectionState GetConnectState(FSocket* socket, double startTime) const;
+
+	void OpenLoginSocket(uint32 ip);
+	void OpenMultiplayerSocket(uint32 ip);
+
+	/* hand a socket that finished connecting to a listener and send everything held for it */
+	void PollLoginConnect();
+	void PollMultiplayerConnect();
+
+	/* start connecting if the socket isn't connected yet, returns false if the connection can't be started */
 	bool ConnectLoginSocket();
 	bool ConnectMultiplayerSocket();
 	void ListenLoginSocket();
@@ -63,6 +153,8 @@ protected:
 public:
 	~URealmGameInstance();
 
+	virtual void Init() override;
+
 	/* attempts to contact the login server and perform a login */
 	bool AttemptLogin(FString username, FString password);
 
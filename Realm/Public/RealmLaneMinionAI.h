@@ -1,7 +1,6 @@
 #pragma once
 
 #include "RealmMoveController.h"
-#include "Runtime/AIModule/Classes/Perception/PawnSensingComponent.h"
 #include "RealmLaneMinionAI.generated.h"
 
 class ALaneManager;
@@ -27,6 +26,8 @@ enum class ELaneMinionTargetPriority : uint8
 UCLASS()
 class ARealmLaneMinionAI : public ARealmMoveController
 {
+	friend class FRealmMinionTargeting;
+
 	GENERATED_UCLASS_BODY()
 
 protected:
@@ -39,9 +40,8 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = Lane)
 	ALaneManager* laneManager;
 
-	/* timer for range checking */
-	UPROPERTY()
-	FTimerHandle rangeTimer;
+	/* world time before which the batched targeting pass skips this minion */
+	float nextTargetingTime;
 
 	/* current target priority */
 	UPROPERTY()
@@ -73,21 +73,31 @@ protected:
 	/* queue of objectives we need to visit to keep pathing in lane*/
 	TQueue<ARealmObjective*> objectives;
 
-	/* target out of aggro range */
-	void ReevaluateTargets();
+	/* check the current target is still valid or pick a new one from the enemies near this minion's cluster */
+	void ReevaluateTargets(const TArray<AGameCharacter*>& candidates);
+
+	/* pick the best target out of the candidates in a single pass, minions first then objectives then mythos */
+	void AcquireTarget(const TArray<AGameCharacter*>& candidates);
 
 	/* check for reached objectives */
 	void CheckReachedObjective();
 
-	/* called whenever an enemy walks into attack radius */
-	UFUNCTION()
-	virtual void OnTargetEnterRadius(class APawn* seenPawn) override;
+	virtual void ScheduledUpdate() override;
 
 	/* set a new target for this minion */
 	void SetNewTarget(AGameCharacter* newTarget, ELaneMinionTargetPriority targetPriority);
 
+	/* queue up the lane's objectives and start walking to the first one */
+	void StartLane();
+
 public:
 
+	/* stop thinking while our minion waits in the lane's pool */
+	void Park();
+
+	/* forget everything from the minion's last life and start the lane over */
+	void ResetForReuse();
+
 	virtual void Possess(APawn* InPawn) override;
 
 	void SetLaneManager(ALaneManager* newLaneManager);
@@ -98,5 +108,7 @@ public:
 
 	virtual void Destroy(bool bNetForce /* = false */, bool bShouldModifyLevel /* = true */);
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void CharacterInAttackRange() override;
 };
\ No newline at end of file
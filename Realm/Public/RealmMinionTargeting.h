@@ -0,0 +1,46 @@
+#pragma once
+
+class ARealmLaneMinionAI;
+class AGameCharacter;
+class FRealmCharacterHash;
+
+/* size in world units of the cells lane minions are grouped into so each group can share one target query */
+const static float MINION_TARGETING_CLUSTER_SIZE = 600.f;
+
+/* finds targets for every lane minion in one batched pass instead of each minion sweeping for targets on its own timer */
+class FRealmMinionTargeting
+{
+	/* every lane minion controller being targeted for */
+	TArray<ARealmLaneMinionAI*> minions;
+
+	/* lane minions grouped by team and cell, rebuilt each pass */
+	TMap<int64, TArray<ARealmLaneMinionAI*> > clusters;
+
+	/* enemies near the cluster currently being processed */
+	TArray<AGameCharacter*> clusterCandidates;
+
+	/* time between targeting passes */
+	float targetingInterval;
+
+	/* time since the last targeting pass */
+	float timeSinceLastPass;
+
+	/* retarget every minion in the cluster against one shared set of nearby enemies */
+	void ProcessCluster(const TArray<ARealmLaneMinionAI*>& cluster, const FRealmCharacterHash& characterHash);
+
+public:
+
+	FRealmMinionTargeting();
+
+	/* set how often the targeting pass runs */
+	void SetTargetingInterval(float newInterval);
+
+	/* start finding targets for a lane minion */
+	void AddMinion(ARealmLaneMinionAI* minionAI);
+
+	/* stop finding targets for a lane minion */
+	void RemoveMinion(ARealmLaneMinionAI* minionAI);
+
+	/* run the targeting pass for all lane minions if enough time has passed */
+	void Update(float deltaSeconds, float worldTime, const FRealmCharacterHash& characterHash);
+};
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "AIController.h"
-#include "Runtime/AIModule/Classes/Perception/PawnSensingComponent.h"
 #include "RealmMoveController.generated.h"
 
 class AGameCharacter;
@@ -9,20 +8,21 @@ class AGameCharacter;
 UCLASS()
 class ARealmMoveController : public AAIController
 {
+	friend class FRealmAIScheduler;
+
 	GENERATED_UCLASS_BODY()
 
 protected:
 
-	/* the radius or range that an enemy has to enter to be able to be targeted by this minion */
-	UPROPERTY(VisibleAnywhere, Category = Minion)
-	UPawnSensingComponent* targetRadius;
+	/* time in seconds between this controller's scheduled updates */
+	UPROPERTY(EditDefaultsOnly, Category = Scheduling)
+	float updateInterval;
 
-	/* array of enemy units that are currently in range of this minion */
-	TArray<AGameCharacter*> inRangeTargets;
+	/* world time this controller's next scheduled update is due */
+	float nextScheduledUpdateTime;
 
-	/* called whenever an enemy walks into attack radius */
-	UFUNCTION()
-	virtual void OnTargetEnterRadius(class APawn* seenPawn);
+	/* periodic update run by the game mode's AI scheduler */
+	virtual void ScheduledUpdate();
 
 public:
 
@@ -33,6 +33,7 @@ public:
 
 	virtual void CharacterInAttackRange();
 	virtual void Possess(APawn* inPawn) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/* called whenever the game has ended */
 	void GameEnded();
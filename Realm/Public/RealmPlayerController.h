@@ -12,6 +12,7 @@ UCLASS()
 class ARealmPlayerController : public APlayerController
 {
 	friend class AGameCharacter;
+	friend class URealmFogofWarManager;
 
 	GENERATED_UCLASS_BODY()
 
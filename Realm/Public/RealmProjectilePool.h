@@ -0,0 +1,31 @@
+#pragma once
+
+class AProjectile;
+
+/* parked projectiles waiting to be reused so auto attacks and skills don't spawn a new replicated actor every shot */
+class FRealmProjectilePool
+{
+	/* parked projectiles, one list per projectile class */
+	TMap<UClass*, TArray<AProjectile*> > pool;
+
+	/* amount of projectiles currently parked */
+	int32 parkedProjectiles;
+
+	/* stats for the pool report */
+	int32 requests;
+	int32 hits;
+	int32 peakSize;
+
+public:
+
+	FRealmProjectilePool();
+
+	/* get a parked projectile of the given class or spawn a new one, then activate it at the location */
+	AProjectile* Acquire(UWorld* world, TSubclassOf<AProjectile> projectileClass, const FVector& location, const FRotator& rotation);
+
+	/* park a projectile for reuse, returns false if its class already has a full pool and it should be destroyed */
+	bool Release(AProjectile* projectile);
+
+	/* log how often the pool was able to hand out a parked projectile */
+	void Report() const;
+};
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "RealmMoveController.h"
-#include "Runtime/AIModule/Classes/Perception/PawnSensingComponent.h"
 #include "RealmRaiderAI.generated.h"
 
 class ARaiderCharacter;
@@ -28,8 +27,8 @@ protected:
 	/* queue of objectives we need to visit to keep pathing in lane*/
 	TQueue<ARealmObjective*> objectives;
 
-	/* timer for range checking */
-	FTimerHandle rangeTimer, spawnIntroTimer;
+	/* timer for the spawn intro, the raider doesn't act until it finishes */
+	FTimerHandle spawnIntroTimer;
 
 	/* location that this raider spawned */
 	FVector spawnLocation;
@@ -40,6 +39,8 @@ protected:
 	/* check for reached objectives */
 	void CheckReachedObjective();
 
+	virtual void ScheduledUpdate() override;
+
 public:
 
 	/* lane manager that controls this minion */
@@ -0,0 +1,48 @@
+#pragma once
+
+class AGameCharacter;
+
+/* health and flare regeneration for every character below max, applied from one pass at a fixed interval instead of a pair of timers per character */
+class FRealmRegeneration
+{
+	/* characters missing health or flare, in no particular order */
+	TArray<AGameCharacter*> characters;
+
+	/* index into characters for each registered character */
+	TMap<AGameCharacter*, int32> characterIndices;
+
+	/* seconds between regeneration passes */
+	float regenInterval;
+
+	/* time since the last pass */
+	float timeSinceLastPass;
+
+	/* amount of characters regenerated in the last pass */
+	int32 lastPassCount;
+
+	/* remove the character at the index and keep the moved character's index up to date */
+	void RemoveAt(int32 index);
+
+public:
+
+	FRealmRegeneration();
+
+	/* start regenerating a character, does nothing if it already is */
+	void AddCharacter(AGameCharacter* gc);
+
+	/* stop regenerating a character */
+	void RemoveCharacter(AGameCharacter* gc);
+
+	/* regenerate every character in the list once per interval, dropping the ones that are full or dead */
+	void Update(float deltaSeconds);
+
+	int32 Num() const
+	{
+		return characters.Num();
+	}
+
+	int32 GetLastPassCount() const
+	{
+		return lastPassCount;
+	}
+};
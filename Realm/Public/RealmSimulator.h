@@ -0,0 +1,106 @@
+#pragma once
+
+/* settings and per subsystem timings for a headless match simulation, enabled with -realmsim on the server */
+class FRealmSimulator
+{
+	/* accumulated wall time spent in one subsystem */
+	struct FTimingBucket
+	{
+		double totalTime = 0.0;
+		double peakTime = 0.0;
+		int32 samples = 0;
+	};
+
+	/* whether or not this server is running a simulation instead of hosting a match */
+	bool bEnabled;
+
+	/* amount of bot players on each team */
+	int32 botsPerTeam;
+
+	/* amount of simulated minutes before the server exits */
+	float simulatedMinutes;
+
+	/* seed for all of the game's random numbers */
+	int32 seed;
+
+	/* fixed time step the world is ticked with */
+	float fixedTimeStep;
+
+	/* simulated time since the simulation started */
+	double simulatedTime;
+
+	/* wall time the simulation started */
+	double wallStartTime;
+
+	/* amount of frames simulated */
+	int32 frameCount;
+
+	/* whether or not the simulation has finished and reported */
+	bool bFinished;
+
+	/* timings for each subsystem, in the order they were first recorded */
+	TArray<FName> timingOrder;
+	TMap<FName, FTimingBucket> timings;
+
+public:
+
+	FRealmSimulator();
+
+	/* read the simulation settings from the command line, returns whether or not a simulation was requested */
+	bool ParseCommandLine();
+
+	/* seed the random numbers and switch the engine to a fixed time step */
+	void Start();
+
+	/* advance the simulated clock, returns true once the simulation has run for long enough */
+	bool Tick(float deltaSeconds);
+
+	/* add time spent in a subsystem this frame */
+	void AddTiming(FName subsystem, double seconds);
+
+	/* log the timings of every subsystem */
+	void Report() const;
+
+	/* mark the simulation as done so it only reports once */
+	void Finish()
+	{
+		bFinished = true;
+	}
+
+	bool IsEnabled() const
+	{
+		return bEnabled;
+	}
+
+	bool IsFinished() const
+	{
+		return bFinished;
+	}
+
+	int32 GetBotsPerTeam() const
+	{
+		return botsPerTeam;
+	}
+};
+
+/* times the scope and adds it to the simulator's timings, does nothing unless a simulation is running */
+class FRealmSimulatorScope
+{
+	FRealmSimulator* simulator;
+	FName subsystem;
+	double startTime;
+
+public:
+
+	FRealmSimulatorScope(FRealmSimulator* inSimulator, FName inSubsystem)
+	: simulator(inSimulator && inSimulator->IsEnabled() ? inSimulator : nullptr), subsystem(inSubsystem), startTime(simulator ? FPlatformTime::Seconds() : 0.0)
+	{
+
+	}
+
+	~FRealmSimulatorScope()
+	{
+		if (simulator)
+			simulator->AddTiming(subsystem, FPlatformTime::Seconds() - startTime);
+	}
+};
@@ -1,20 +1,61 @@
 #pragma once
 
+#include "RealmBackendProtocol.h"
+
 class URealmGameInstance;
 
+/* a complete frame waiting for the game thread */
+struct FRealmBackendFrame
+{
+	/* message type followed by its fields */
+	TArray<uint8> data;
+
+	/* FPlatformTime::Seconds when the listener queued the frame */
+	double enqueueTime;
+};
+
+/* longest the listener blocks on the socket before checking whether it should stop */
+const static float SOCKET_LISTENER_WAIT_TIME = 0.1f;
+
+/* seconds between idle reports from each listener */
+const static float SOCKET_LISTENER_REPORT_INTERVAL = 60.f;
+
 class FRealmSocketListener : public FRunnable
 {
 	FRunnableThread* listenerThread;
 	FThreadSafeCounter stopListenerThread;
 
+	/* triggered on stop so the thread doesn't sleep out its wait while it has no socket to block on */
+	FEvent* stopEvent;
+
 	FSocket* listenSocket;
 
 	bool bLoginSocket = false;
 
+	/* set once the other end closes the connection or the stream can't be parsed, after which there's nothing left to wait on */
+	FThreadSafeBool bConnectionClosed;
+
+	/* idle stats for the current report, only touched by the listener thread */
+	double reportStartTime = 0.0;
+	double idleTime = 0.0;
+	int32 wakeups = 0;
+	int32 reads = 0;
+	int64 bytesReceived = 0;
+
+	/* bytes received but not yet cut into whole frames */
+	FRealmBackendStream stream;
+
+	/* scratch buffer each read lands in */
+	TArray<uint8> recvBuffer;
+
+	/* read everything the socket has waiting and queue each complete frame */
 	void ListenForData();
 
-	/* queue for uobjects to get data from this listener */
-	TQueue<TArray<uint8> > dataQueue;
+	/* log how much of the last report interval the thread spent blocked */
+	void ReportIdleStats();
+
+	/* complete frames for uobjects to get from this listener, queued as pointers so the payload is never copied on the way through */
+	TQueue<FRealmBackendFrame*> dataQueue;
 
 public:
 
@@ -34,7 +75,22 @@ public:
 
 	void Shutdown();
 
-	void GetNextDataArray(TArray<uint8>& outArray);
+	/* move the oldest queued frame into outFrame, returns false if nothing is waiting */
+	bool DequeueFrame(TArray<uint8>& outFrame, double& outEnqueueTime);
+
+	/* cut bytes received from the socket into frames and queue the whole ones, closing the connection if the stream is corrupt */
+	void ReceiveBytes(const uint8* data, int32 size);
+
+	/* whether the connection is done with, the owner should drop it once the queue is empty */
+	bool IsConnectionClosed() const
+	{
+		return bConnectionClosed;
+	}
+
+	bool HasQueuedFrames() const
+	{
+		return !dataQueue.IsEmpty();
+	}
 
 	static FRealmSocketListener* CreateListener(FSocket* socketToListenTo, bool bLoginSocket);
 };
\ No newline at end of file
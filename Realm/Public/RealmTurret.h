@@ -2,7 +2,6 @@
 
 #include "RealmObjective.h"
 #include "DamageInstance.h"
-#include "Runtime/AIModule/Classes/Perception/PawnSensingComponent.h"
 #include "RealmTurret.generated.h"
 
 UCLASS()
@@ -33,9 +32,8 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditDefaultsOnly, Category = Priority)
 	bool bPrioritizeMythos;
 
-	/* called when a component overlaps, sets the first enemy that enters this radius as the current target */
-	UFUNCTION()
-	void OnSeePawn(APawn* OtherActor);
+	/* start attacking the best enemy in range, called by the turret's AI while it has no target */
+	void AcquireTarget();
 
 	virtual void OnFinishAATimer() override;
 
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "RealmMoveController.h"
-#include "Runtime/AIModule/Classes/Perception/PawnSensingComponent.h"
 #include "RealmTurretAI.generated.h"
 
 class ALaneManager;
@@ -16,11 +15,6 @@ class ARealmTurretAI : public ARealmMoveController
 
 protected:
 
-	/* for sensing pawns that come into our radius */
-	UPROPERTY(EditDefaultsOnly, Category = Sensing)
-	UPawnSensingComponent* pawnSensor;
-
-	/* called when a component overlaps, sets the first enemy that enters this radius as the current target */
-	UFUNCTION()
-	void OnSeePawn(APawn* OtherActor);
+	/* look for a new target whenever the turret doesn't have one */
+	virtual void ScheduledUpdate() override;
 };
\ No newline at end of file
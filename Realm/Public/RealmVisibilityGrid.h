@@ -0,0 +1,128 @@
+#pragma once
+
+/* max amount of teams the vision grid can hold in each cell's bitmask */
+const static int32 VISION_MAX_TEAMS = 8;
+
+/* height above the ground that sight is tested at when baking occluders */
+const static float VISION_EYE_HEIGHT = 100.f;
+
+/* identifier and version of the baked occluder files, bump the version whenever the file layout changes */
+const static int32 VISION_BAKE_MAGIC = 0x52564953;
+const static int32 VISION_BAKE_VERSION = 1;
+
+/* max amount of cached line of sight results before the cache is flushed */
+const static int32 VISION_LOS_CACHE_SIZE = 65536;
+
+/* cached set of cells a single observer gives its team sight of, only rebuilt when the observer changes cell, radius or team */
+struct FRealmVisionFootprint
+{
+	/* indices of the cells this observer can see */
+	TArray<int32> cells;
+
+	/* cell the observer was in when the footprint was built */
+	int32 centerCell = INDEX_NONE;
+
+	/* sight radius the footprint was built with */
+	float radius = 0.f;
+
+	/* team the footprint gives sight to */
+	int32 team = INDEX_NONE;
+};
+
+/* 2D grid of the map that team vision is rasterized into, so vision can be calculated without physics queries */
+class FRealmVisibilityGrid
+{
+	/* world location of the corner of the first cell */
+	FVector2D gridOrigin;
+
+	/* size of each cell in world units */
+	float cellSize;
+
+	/* amount of cells along each axis */
+	int32 gridWidth, gridHeight;
+
+	/* non zero for every cell that blocks sight */
+	TArray<uint8> occlusionCells;
+
+	/* bitmask of the teams that currently have sight of each cell */
+	TArray<uint8> visibleCells;
+
+	/* amount of footprints giving each team sight of each cell, indexed by cell * VISION_MAX_TEAMS + team */
+	TArray<uint16> visionCounts;
+
+	/* incremented every time a team's vision changes so callers can skip work when nothing changed */
+	uint32 teamGenerations[VISION_MAX_TEAMS];
+
+	/* whether or not the grid has been built for the current map */
+	bool bInitialized = false;
+
+	/* cached line of sight results between two cells, the occluders never change so these never go stale */
+	mutable TMap<uint64, bool> lineOfSightCache;
+
+	/* get the index into the cell arrays for the specified cell */
+	FORCEINLINE int32 GetCellIndex(int32 x, int32 y) const
+	{
+		return y * gridWidth + x;
+	}
+
+	/* whether or not there is nothing blocking sight between the two cells */
+	bool IsCellLineClear(int32 fromX, int32 fromY, int32 toX, int32 toY) const;
+
+	/* fill the footprint with all of the cells in radius around the center that aren't blocked by an occluder */
+	void RasterizeFootprint(FRealmVisionFootprint& footprint, int32 centerX, int32 centerY) const;
+
+	/* add or remove a footprint's sight from the team counts */
+	void ApplyFootprint(const FRealmVisionFootprint& footprint, bool bAdd);
+
+	/* clear the vision state so footprints can be applied from scratch */
+	void ResetVision();
+
+	/* get the playable bounds of the map to build the grid over */
+	static FBox CalculateVisionBounds(UWorld* world);
+
+	/* test the level geometry for every cell to find which ones block sight */
+	void BakeOcclusion(UWorld* world, const FBox& bounds);
+
+	/* load occluders from a baked file, returns false if the file is missing or its cell size or bounds don't match the map as it is now */
+	bool LoadBakeFile(const FString& filePath, float expectedCellSize, const FVector2D& expectedOrigin, int32 expectedWidth, int32 expectedHeight);
+
+	/* write the occluders to a baked file */
+	bool SaveBakeFile(const FString& filePath) const;
+
+public:
+
+	FRealmVisibilityGrid();
+
+	/* load the baked occluders for the map, or bake them from the level geometry if there is no bake yet */
+	void BuildForWorld(UWorld* world, float newCellSize);
+
+	/* get the path to the map's occluder bake, either the one shipped with the content or the one baked on first boot */
+	static FString GetBakeFilePath(UWorld* world, bool bShippedBake);
+
+	/* whether or not this grid has been built and can be queried */
+	bool IsInitialized() const
+	{
+		return bInitialized;
+	}
+
+	/* move an observer's sight footprint, returns false without doing any work if it is still in the same cell with the same radius and team */
+	bool UpdateFootprint(FRealmVisionFootprint& footprint, int32 team, const FVector& location, float radius);
+
+	/* remove an observer's sight from the grid */
+	void RemoveFootprint(FRealmVisionFootprint& footprint);
+
+	/* get the current vision generation of the team */
+	uint32 GetTeamGeneration(int32 team) const
+	{
+		return (team >= 0 && team < VISION_MAX_TEAMS) ? teamGenerations[team] : 0;
+	}
+
+	/* whether or not the specified team has sight of the world location */
+	bool IsLocationVisibleToTeam(int32 team, const FVector& location) const;
+
+	/* whether or not there are no occluders between the two world locations, results are cached */
+	bool HasLineOfSight(const FVector& from, const FVector& to) const;
+
+	/* get the cell that contains the world location, returns false if the location is outside of the grid */
+	bool WorldToCell(const FVector& location, int32& outX, int32& outY) const;
+};
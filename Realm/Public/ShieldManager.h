@@ -4,6 +4,9 @@
 
 class AGameCharacter;
 
+/* max amount of shields a character can have at once */
+const static int32 MAX_SHIELDS = 8;
+
 USTRUCT()
 struct FCharacterShield
 {
@@ -20,14 +23,16 @@ struct FCharacterShield
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Shield)
 	float duration;
 
-	/* timer handle for this shield */
-	UPROPERTY(BlueprintReadOnly, Category = Shield)
-	FTimerHandle timer;
-
 	/* types of damage this shield absorbs */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Shield)
 	TArray<TSubclassOf<UDamageType> > damageTypes;
 
+	/* damage types as bits, built from damageTypes when the shield is added */
+	uint32 damageTypeMask = 0;
+
+	/* world time this shield runs out */
+	float expireTime = 0.f;
+
 	/* keyname for this shield */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Shield)
 	FString key;
@@ -42,9 +47,14 @@ class AShieldManager : public AActor
 {
 	GENERATED_UCLASS_BODY()
 
-	/* array of shields this character currently has */
+	/* shields this character currently has, ordered by the time they run out */
 	UPROPERTY()
-	TMap<FString, FCharacterShield> shields;
+	FCharacterShield shields[MAX_SHIELDS];
+
+	int32 shieldCount;
+
+	/* one timer for the shield that runs out first */
+	FTimerHandle expiryTimer;
 
 	/* replicated total shield amount for things like UI */
 	UPROPERTY(replicated)
@@ -55,6 +65,18 @@ protected:
 	/* updates the total shield amount */
 	void UpdateTotalShieldAmount();
 
+	/* remove the shield at the index, keeping the rest in order */
+	void RemoveShieldAt(int32 index);
+
+	/* remove every shield that has run out and wait for the next one */
+	void ExpireShields();
+
+	/* point the expiry timer at the first shield to run out */
+	void UpdateExpiryTimer();
+
+	/* get the bit for a damage type, bits are handed out the first time a shield uses the type */
+	static uint32 GetDamageTypeMask(UClass* damageType, bool bRegister);
+
 public:
 	
 	/* reference to the character that owns this manager */
@@ -79,7 +101,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Effect)
 	void ShieldFinished(FCharacterShield finishingShield);
 
-	/* goes through the shields and determines whether or not the specified character has applied any shield to this character. not a fast function since we have to iterate over the entire hash map */
+	/* goes through the shields and determines whether or not the specified character has applied any shield to this character */
 	UFUNCTION(BlueprintCallable, Category = Shield)
 	bool DoesContainCharactersShield(AGameCharacter* originatingUnit);
 };
\ No newline at end of file
@@ -4,7 +4,7 @@
 
 class AMod;
 class AGameCharacter;
-class AEffect;
+class UStatsManager;
 
 UENUM(BlueprintType)
 enum class EStat : uint8
@@ -39,11 +39,120 @@ enum class EStat : uint8
 	ES_Max UMETA(Hidden)
 };
 
+static_assert((uint8)EStat::ES_Max <= 32, "the stats manager tracks dirty stats in a 32 bit mask");
+
+/* called with the stat and its new value whenever something that feeds into a stat changes */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnStatChanged, EStat, float);
+
+/* a buff or debuff on a character */
+USTRUCT(BlueprintType)
+struct FRealmEffect : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* effect name */
+	UPROPERTY(BlueprintReadWrite, Category = Effect)
+	FText uiName;
+
+	/* effect description */
+	UPROPERTY(BlueprintReadWrite, Category = Effect)
+	FText description;
+
+	/* name of the effect for game reasons */
+	UPROPERTY(BlueprintReadWrite, Category = Effect)
+	FString keyName;
+
+	/* stat(s) this effect affects */
+	UPROPERTY(NotReplicated, BlueprintReadWrite, Category = Effect)
+	TArray<TEnumAsByte<EStat> > stats;
+
+	/* amounts of stats this effects */
+	UPROPERTY(NotReplicated, BlueprintReadWrite, Category = Effect)
+	TArray<float> amounts;
+
+	/* duration of the effect */
+	UPROPERTY(BlueprintReadWrite, Category = Effect)
+	float duration;
+
+	/* whether or not this is a stacking effect */
+	UPROPERTY(BlueprintReadWrite, Category = Effect)
+	bool bStacking;
+
+	/* amount of stacks this effect has (if can stack) */
+	UPROPERTY(BlueprintReadWrite, Category = Effect)
+	int32 stackAmount;
+
+	/* does this effect persist through death? */
+	UPROPERTY(NotReplicated, BlueprintReadWrite, Category = Effect)
+	bool bPersistThroughDeath;
+
+	/* is this effect transfered to a player killer? */
+	UPROPERTY(NotReplicated, BlueprintReadWrite, Category = Effect)
+	bool bIsTransferredToPlayerKiller;
+
+	/* whether or not this effect can be added multiple times to one character */
+	UPROPERTY(NotReplicated, BlueprintReadWrite, Category = Effect)
+	bool bCanBeInflictedMultipleTimes;
+
+	/* bumped every time the effect's timer is reset so clients restart their countdown */
+	UPROPERTY()
+	uint8 timerResets;
+
+	/* [SERVER] timer handle for the effect */
+	UPROPERTY(NotReplicated)
+	FTimerHandle effectTimer;
+
+	/* [SERVER] id of this effect on its character, so a timer removes the effect it was set for and not another with the same key */
+	int32 effectHandle;
+
+	/* [CLIENT] local time the effect's countdown last started, and the reset count it started for */
+	float localStartTime;
+	uint8 localTimerResets;
+
+	FRealmEffect()
+	: duration(0.f), bStacking(false), stackAmount(0), bPersistThroughDeath(false), bIsTransferredToPlayerKiller(false), bCanBeInflictedMultipleTimes(false), timerResets(0), effectHandle(0), localStartTime(0.f), localTimerResets(0)
+	{
+
+	}
+
+	/* [CLIENT] called when an effect is added, changed or removed */
+	void PreReplicatedRemove(const struct FRealmEffectList& InArraySerializer);
+	void PostReplicatedAdd(const struct FRealmEffectList& InArraySerializer);
+	void PostReplicatedChange(const struct FRealmEffectList& InArraySerializer);
+};
+
+/* every effect on a character, replicated as deltas so only added, changed or removed effects are sent */
+USTRUCT()
+struct FRealmEffectList : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FRealmEffect> items;
+
+	/* stats manager this list belongs to */
+	UStatsManager* owner;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FastArrayDeltaSerialize<FRealmEffect>(items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FRealmEffectList> : public TStructOpsTypeTraitsBase
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 UCLASS()
 class UStatsManager : public UObject
 {
 	friend class UAutoAttackManager;
-	friend class AEffect;
+	friend struct FRealmEffect;
 	friend class AGameCharacter;
 	friend class ARaiderCharacter;
 
@@ -56,13 +165,26 @@ protected:
 	bool bInitialized;
 
 	/* array of base stats for the character */
-	UPROPERTY(replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_Stats)
 	float baseStats[(uint8)EStat::ES_Max];
 
 	/* array of mod stats for the character */
-	UPROPERTY(replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_Stats)
 	float modStats[(uint8)EStat::ES_Max];
 
+	/* array of bonus stats from effects for the character */
+	UPROPERTY(ReplicatedUsing = OnRep_Stats)
+	float bonusStats[(uint8)EStat::ES_Max];
+
+	/* base + mod + bonus for each stat, only recalculated when the stat is dirty */
+	mutable float currentStats[(uint8)EStat::ES_Max];
+
+	/* bit per stat that needs to be recalculated before it is read */
+	mutable uint32 dirtyStats;
+
+	/* listeners for each stat */
+	FOnStatChanged statChangedDelegates[(uint8)EStat::ES_Max];
+
 	/* current health for t	he character */
 	UPROPERTY(replicated)
 	float health;
@@ -75,21 +197,49 @@ protected:
 	UPROPERTY(replicated)
 	AGameCharacter* owningCharacter;
 
-	/* dynamic array of effects that are currently affecting this character */
-	UPROPERTY(ReplicatedUsing = OnRepUpdateEffects)
-	TArray<AEffect*> effectsList;
+	/* every effect that is currently affecting this character */
+	UPROPERTY(Replicated)
+	FRealmEffectList effects;
 
-	/* map for faster effect lookup */
-	TMap<FString, AEffect*> effectsMap;
+	/* [CLIENT] an effect was added, changed or removed */
+	void OnEffectReplicated(FRealmEffect& effect, bool bRemoved);
 
-	UFUNCTION()
-	void OnRepUpdateEffects();
+	/* [CLIENT] effects changed in the last replication batch, the character is told on its next tick once removed items are gone from the list */
+	bool bEffectsDirty;
+
+	/* tell the character (and its hud) the effects changed */
+	void NotifyEffectsUpdated();
+
+	/* take an effect's stats back off and remove it */
+	void RemoveEffectAt(int32 index);
+
+	/* handle given to the last effect added */
+	int32 lastEffectHandle;
+
+	/* an effect's timer ran out */
+	void EffectExpired(int32 effectHandle);
 
 public:
 
-	/* array of base stats for the character */
-	UPROPERTY(replicated)
-	float bonusStats[(uint8)EStat::ES_Max];
+	/* [CLIENT] tell the character about effects that changed since the last call */
+	void FlushEffectsUpdated();
+
+protected:
+
+	/* the replicated stats changed, so every cached stat is stale */
+	UFUNCTION()
+	void OnRep_Stats();
+
+	/* add up the base, mod and bonus values of a stat without the cache */
+	float CalculateStat(EStat stat) const
+	{
+		return baseStats[(int32)stat] + modStats[(int32)stat] + bonusStats[(int32)stat];
+	}
+
+	/* add (or remove with a negative scale) an effect's amounts to the bonus stats */
+	void ApplyEffectStats(const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float scale);
+
+public:
 
 	/* set the health and flare */
 	void SetMaxHealth();
@@ -98,10 +248,31 @@ public:
 	/* initialize the stats manager with a character's base stats */
 	void InitializeStats(float* initBaseStats, AGameCharacter* ownerChar);
 
+	/* drop all effects and go back to the character's base stats (used when a pooled character is reused) */
+	void ResetStats(float* initBaseStats);
+
 	/* gets the current value of the specified stat */
 	UFUNCTION(BlueprintCallable, Category = Stat)
 	float GetCurrentValueForStat(EStat stat) const;
 
+	/* flag a stat to be recalculated and tell anyone listening to it */
+	void MarkStatDirty(EStat stat);
+
+	/* flag every stat to be recalculated */
+	void MarkAllStatsDirty();
+
+	/* set the base value of a stat */
+	void SetBaseStat(EStat stat, float value);
+
+	/* add to the bonus value of a stat */
+	void AddBonusStat(EStat stat, float amount);
+
+	/* get the delegate called whenever the value of the stat may have changed */
+	FOnStatChanged& OnStatChanged(EStat stat)
+	{
+		return statChangedDelegates[(uint8)stat];
+	}
+
 	/* gets the base value of the specified stat */
 	UFUNCTION(BlueprintCallable, Category = Stat)
 	float GetBaseValueForStat(EStat stat) const;
@@ -113,12 +284,12 @@ public:
 	/* update the bonus stats with stats from mods. called each time the mods array updates */
 	void UpdateModStats(TArray<AMod*>& mods);
 
-	/* add buff/debuff to the player's stats */
-	AEffect* AddEffect(FText const& effectName, FText const& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration = 0.f, FString const& keyName = "", bool bStacking = false, bool bMultipleInfliction = false, bool bPersistThroughDeath = false);
+	/* add buff/debuff to the player's stats, returns false if the effect couldn't be added */
+	bool AddEffect(FText const& effectName, FText const& effectDescription, const TArray<TEnumAsByte<EStat> >& stats, const TArray<float>& amounts, float effectDuration = 0.f, FString const& keyName = "", bool bStacking = false, bool bMultipleInfliction = false, bool bPersistThroughDeath = false);
 
-	/* add an already created effect */
+	/* add an already created effect, returns false if the effect couldn't be added */
 	UFUNCTION(BlueprintCallable, Category = Stat)
-	void AddCreatedEffect(AEffect* newEffect);
+	bool AddCreatedEffect(const FRealmEffect& newEffect);
 
 	/* add stacks to an effect */
 	void AddEffectStacks(const FString& effectKey, int32 stackAmount);
@@ -127,19 +298,27 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Effect)
 	void EffectFinished(FString key);
 
+	/* reset an effect's timer and change its duration if needed */
+	UFUNCTION(BlueprintCallable, Category = Effect)
+	void ResetEffectTimer(const FString& effectKey, float newTime = 0.f);
+
 	/* get the effects array */
 	UFUNCTION(BlueprintCallable, Category = Effects)
-	void GetEffects(UPARAM(ref) TArray<AEffect*>& outEffects)
+	void GetEffects(UPARAM(ref) TArray<FRealmEffect>& outEffects)
 	{
-		outEffects.Empty();
-
-		for (int32 i = 0; i < effectsList.Num(); i++)
-			outEffects.Add(effectsList[i]);
+		outEffects = effects.items;
 	}
 
-	/* get the effects array */
+	/* get a copy of an effect, returns false if the character doesn't have it */
+	UFUNCTION(BlueprintCallable, Category = Effects)
+	bool GetEffect(const FString& effectKey, FRealmEffect& outEffect);
+
+	/* find an effect by its key */
+	FRealmEffect* FindEffect(const FString& effectKey);
+
+	/* get the time left on an effect, on clients this is counted from when the effect last replicated */
 	UFUNCTION(BlueprintCallable, Category = Effects)
-	AEffect* GetEffect(const FString& effectKey);
+	float GetEffectTimeRemaining(const FString& effectKey);
 
 	/* clear all effects, keeping those that persist across death if needed */
 	void RemoveAllEffects(bool bFromDeath = true);
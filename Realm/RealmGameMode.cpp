@@ -50,6 +50,11 @@ ARealmGameMode::ARealmGameMode(const FObjectInitializer& objectInitializer)
 	bRankedGame = true;
 
 	ambientLevelUpTime = 130.f;
+	visionCellSize = 100.f;
+	characterHashCellSize = 500.f;
+	aiFrameBudget = 1.f;
+
+	PrimaryActorTick.bCanEverTick = true;
 }
 
 void ARealmGameMode::StartMatch()
@@ -195,6 +200,10 @@ void ARealmGameMode::BeginPlay()
 
 	gameStatus = EGameStatus::GS_Pregame;
 
+	//a simulation seeds the random numbers before anything else uses them
+	if (simulator.ParseCommandLine())
+		simulator.Start();
+
 	uint32 epn = 0;
 	if (FParse::Value(FCommandLine::Get(), TEXT("epn"), epn))
 	{
@@ -204,6 +213,11 @@ void ARealmGameMode::BeginPlay()
 	else
 		expectedPlayerCount = 1;
 
+	visionGrid.BuildForWorld(GetWorld(), visionCellSize);
+	characterHash.SetCellSize(characterHashCellSize);
+	//a wall clock budget would make which controllers update depend on how fast the host is, so simulations run every due update
+	aiScheduler.SetFrameBudget(simulator.IsEnabled() ? 0.f : aiFrameBudget);
+
 	for (int32 i = 0; i < teams.Num(); i++)
 	{
 		FString fogName = GetFName().ToString() + ".fogManager" + FString::FromInt(i);
@@ -215,6 +229,104 @@ void ARealmGameMode::BeginPlay()
 
 		teamFoWs.AddUnique(fogOfWar);
 	}
+
+	if (simulator.IsEnabled())
+	{
+		FTimerHandle simTimer;
+		GetWorldTimerManager().SetTimer(simTimer, this, &ARealmGameMode::StartSimulation, 0.1f, false);
+	}
+}
+
+void ARealmGameMode::StartSimulation()
+{
+	//bots stand in for every player, no clients or login server are involved
+	const int32 botsPerTeam = simulator.GetBotsPerTeam();
+	teamSizeMax = FMath::Max(teamSizeMax, botsPerTeam);
+
+	for (int32 i = 0; i < teams.Num(); i++)
+	{
+		for (int32 j = 0; j < botsPerTeam && availableCharacters.Num() > 0; j++)
+		{
+			ARealmBotController* bot = GetWorld()->SpawnActor<ARealmBotController>(ARealmBotController::StaticClass());
+			if (!IsValid(bot))
+				continue;
+
+			ARealmPlayerState* ps = Cast<ARealmPlayerState>(bot->PlayerState);
+			if (IsValid(ps))
+			{
+				ps->SetTeamIndex(i);
+				teams[i].players.AddUnique(ps);
+				ps->SetTeamPlayerIndex(teams[i].players.Num() - 1);
+				ps->SetChosenCharacterClass(availableCharacters[FMath::RandRange(0, availableCharacters.Num() - 1)]);
+			}
+
+			AActor* start = FindPlayerStart(bot);
+			const FVector spawnLocation = IsValid(start) ? start->GetActorLocation() : FVector::ZeroVector;
+			APlayerCharacter* character = GetWorld()->SpawnActor<APlayerCharacter>(IsValid(ps) ? ps->GetChosenCharacterClass() : availableCharacters[0], spawnLocation, FRotator::ZeroRotator);
+			if (IsValid(character))
+			{
+				character->SetTeamIndex(i);
+				bot->Possess(character);
+			}
+		}
+	}
+
+	StartMatch();
+	gameStatus = EGameStatus::GS_Ingame;
+}
+
+void ARealmGameMode::FinishSimulation()
+{
+	if (simulator.IsFinished())
+		return;
+
+	simulator.Finish();
+	simulator.Report();
+
+	for (TActorIterator<ALaneManager> laneitr(GetWorld()); laneitr; ++laneitr)
+		(*laneitr)->ReportMinionPool();
+
+	projectilePool.Report();
+
+	FPlatformMisc::RequestExit(false);
+}
+
+void ARealmGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	{
+		FRealmSimulatorScope scope(&simulator, TEXT("CharacterHash"));
+		characterHash.Update();
+	}
+
+	{
+		FRealmSimulatorScope scope(&simulator, TEXT("MinionTargeting"));
+		minionTargeting.Update(DeltaSeconds, GetWorld()->GetTimeSeconds(), characterHash);
+	}
+
+	{
+		FRealmSimulatorScope scope(&simulator, TEXT("AIScheduler"));
+		aiScheduler.Update(DeltaSeconds, GetWorld()->GetTimeSeconds());
+	}
+
+	{
+		FRealmSimulatorScope scope(&simulator, TEXT("AutoAttackShots"));
+		autoAttackShots.Update(DeltaSeconds);
+	}
+
+	{
+		FRealmSimulatorScope scope(&simulator, TEXT("DamageOverTime"));
+		damageOverTime.Update(GetWorld()->GetTimeSeconds());
+	}
+
+	{
+		FRealmSimulatorScope scope(&simulator, TEXT("Regeneration"));
+		regeneration.Update(DeltaSeconds);
+	}
+
+	if (simulator.Tick(DeltaSeconds))
+		FinishSimulation();
 }
 
 void ARealmGameMode::PostLogin(APlayerController* NewPlayer)
@@ -549,12 +661,22 @@ void ARealmGameMode::EndRealmMatch()
 		GetWorldTimerManager().ClearAllTimersForObject((*gamechr));
 	}*/
 
+	//simulations have nobody to report the end game to
+	if (simulator.IsEnabled())
+	{
+		FinishSimulation();
+		return;
+	}
+
 	CalculateEndgame();
 	for (TActorIterator<ALaneManager> laneitr(GetWorld()); laneitr; ++laneitr)
 	{
 		GetWorldTimerManager().ClearAllTimersForObject(*laneitr);
+		(*laneitr)->ReportMinionPool();
 	}
 
+	projectilePool.Report();
+
 	for (FConstPlayerControllerIterator plyr = GetWorld()->GetPlayerControllerIterator(); plyr; ++plyr)
 	{
 		ARealmPlayerController* pc = Cast<ARealmPlayerController>((*plyr));
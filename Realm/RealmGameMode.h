@@ -3,6 +3,15 @@
 #pragma once
 
 #include "GameFramework/GameMode.h"
+#include "RealmVisibilityGrid.h"
+#include "RealmCharacterHash.h"
+#include "RealmMinionTargeting.h"
+#include "RealmAIScheduler.h"
+#include "RealmSimulator.h"
+#include "RealmProjectilePool.h"
+#include "RealmAutoAttackShots.h"
+#include "RealmDamageOverTime.h"
+#include "RealmRegeneration.h"
 #include "RealmGameMode.generated.h"
 
 class AMod;
@@ -154,8 +163,55 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = MinionLevel)
 	float ambientLevelUpTime;
 
+	/* size in world units of each cell of the vision grid */
+	UPROPERTY(EditDefaultsOnly, Category = Sight)
+	float visionCellSize;
+
+	/* grid the fog of war managers rasterize team vision into */
+	FRealmVisibilityGrid visionGrid;
+
+	/* size in world units of each cell of the character hash */
+	UPROPERTY(EditDefaultsOnly, Category = Sight)
+	float characterHashCellSize;
+
+	/* spatial hash of every character in the game for range queries */
+	FRealmCharacterHash characterHash;
+
+	/* batched target selection for every lane minion */
+	FRealmMinionTargeting minionTargeting;
+
+	/* max amount of time in milliseconds AI controller updates can take each frame, 0 for no limit */
+	UPROPERTY(EditDefaultsOnly, Category = AI)
+	float aiFrameBudget;
+
+	/* time-sliced periodic updates for every AI controller */
+	FRealmAIScheduler aiScheduler;
+
+	/* headless match simulation settings and timings, only active with -realmsim */
+	FRealmSimulator simulator;
+
+	/* parked projectiles shared by every character's auto attacks and skills */
+	FRealmProjectilePool projectilePool;
+
+	/* homing auto attacks in flight */
+	FRealmAutoAttackShots autoAttackShots;
+
+	/* every damage over time effect in the match */
+	FRealmDamageOverTime damageOverTime;
+
+	/* health and flare regeneration for every character below max */
+	FRealmRegeneration regeneration;
+
+	/* spawn the bot players and start the match for a headless simulation */
+	void StartSimulation();
+
+	/* log the simulation timings and shut the server down */
+	void FinishSimulation();
+
 	virtual void BeginPlay() override;
 
+	virtual void Tick(float DeltaSeconds) override;
+
 	/* each time a player logs in, check to see if we can start the game */
 	void CheckForCharacterSelect();
 
@@ -238,4 +294,58 @@ public:
 
 	/* called when a raider dies */
 	void OnRaiderDeath(bool bDespawned = false);
+
+	/* get the vision grid for this map */
+	FRealmVisibilityGrid& GetVisionGrid()
+	{
+		return visionGrid;
+	}
+
+	/* get the spatial hash of every character in the game */
+	FRealmCharacterHash& GetCharacterHash()
+	{
+		return characterHash;
+	}
+
+	/* get the batched lane minion targeting */
+	FRealmMinionTargeting& GetMinionTargeting()
+	{
+		return minionTargeting;
+	}
+
+	/* get the scheduler that runs AI controller updates */
+	FRealmAIScheduler& GetAIScheduler()
+	{
+		return aiScheduler;
+	}
+
+	/* get the headless match simulator */
+	FRealmSimulator& GetSimulator()
+	{
+		return simulator;
+	}
+
+	/* get the projectile pool */
+	FRealmProjectilePool& GetProjectilePool()
+	{
+		return projectilePool;
+	}
+
+	/* get the server simulated auto attack shots */
+	FRealmAutoAttackShots& GetAutoAttackShots()
+	{
+		return autoAttackShots;
+	}
+
+	/* get the damage over time ticker */
+	FRealmDamageOverTime& GetDamageOverTime()
+	{
+		return damageOverTime;
+	}
+
+	/* get the regeneration pass */
+	FRealmRegeneration& GetRegeneration()
+	{
+		return regeneration;
+	}
 };